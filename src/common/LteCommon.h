@@ -576,6 +576,16 @@ struct UeAllocationInfo{
     Direction dir;
 };
 
+// aggregated uplink interference perceived by a receiving cell
+struct UlInterferenceInfo{
+    // version of the UL transmission map used to compute the interference
+    unsigned long version;
+    // interference power (linear) for each band
+    std::vector<double> power;
+    // UEs contributing to the interference
+    std::set<MacNodeId> interferers;
+};
+
 typedef std::vector<ExtCell*> ExtCellList;
 typedef std::vector<BackgroundScheduler*> BackgroundSchedulerList;
 
@@ -15,6 +15,7 @@
 #include <algorithm>
 #include "stack/mac/layer/LteMacUe.h"
 #include "stack/phy/layer/LtePhyUe.h"
+#include "stack/phy/ChannelModel/LteRealisticChannelModel.h"
 
 #include "corenetwork/statsCollector/BaseStationStatsCollector.h"
 #include "corenetwork/statsCollector/UeStatsCollector.h"
@@ -171,19 +172,32 @@ void Binder::unregisterNode(MacNodeId id)
     if(nodeIds_.erase(id) != 1){
         EV_ERROR << "Cannot unregister node - node id \"" << id << "\" - not found";
     }
+
+    // remove 'id' from the UE lookup tables
+    if (id < ueInfoById_.size())
+        ueInfoById_[id] = nullptr;
+    for (auto &carrier : ueChannelModels_)
+    {
+        if (id < carrier.second.size())
+            carrier.second[id] = nullptr;
+    }
     // remove 'id' from ulTransmissionMap_ if currently scheduled
     for(auto &carrier : ulTransmissionMap_){ // all carrier frequency
-        for(auto &bands : carrier.second){ // all RB's for current and last TTI (vector<vector<vector<UeAllocationInfo>>>)
-            for(auto &ues : bands){ // all Ue's in each block
+        for(unsigned int t = 0; t < carrier.second.size(); t++){ // all RB's for current and last TTI (vector<vector<vector<UeAllocationInfo>>>)
+            bool changed = false;
+            for(auto &ues : carrier.second[t]){ // all Ue's in each block
                 auto itr = ues.begin();
                 while(itr != ues.end()){
                     if (itr->nodeId == id){
                         itr = ues.erase(itr);
+                        changed = true;
                     } else {
                         itr++;
                     }
                 }
             }
+            if (changed)
+                markUlTransmissionMapChanged(carrier.first, (UlTransmissionMapTTI)t);
         }
     }
 }
@@ -266,7 +280,10 @@ void Binder::registerMasterNode(MacNodeId masterId, MacNodeId slaveId)
 void Binder::initialize(int stage)
 {
     if (stage == inet::INITSTAGE_LOCAL)
+    {
         phyPisaData.setBlerShift(par("blerShift"));
+        phyPisaData.setBlerTableResolution(par("blerTableResolution"));
+    }
 
     if (stage == inet::INITSTAGE_LAST)
     {
@@ -506,6 +523,10 @@ void Binder::initAndResetUlTransmissionInfo()
         // the second element (i.e. referring to the old time slot) becomes the first element
         if (!(it->second.empty()))
             it->second.erase(it->second.begin());
+
+        // the aggregated interference of the previous TTI is not moved along, since the UEs may have moved since it was computed
+        markUlTransmissionMapChanged(it->first, PREV_TTI);
+        markUlTransmissionMapChanged(it->first, CURR_TTI);
     }
     lastUpdateUplinkTransmissionInfo_ = NOW;
 }
@@ -525,6 +546,7 @@ void Binder::storeUlTransmissionMap(double carrierFreq, Remote antenna, RbMap& r
         ulTransmissionMap_[carrierFreq].resize(2);
         ulTransmissionMap_[carrierFreq][PREV_TTI].resize(numCarrierBands);
         ulTransmissionMap_[carrierFreq][CURR_TTI].resize(numCarrierBands);
+        markUlTransmissionMapChanged(carrierFreq, PREV_TTI);
     }
     else if (ulTransmissionMap_[carrierFreq].size() == 1)
     {
@@ -543,6 +565,7 @@ void Binder::storeUlTransmissionMap(double carrierFreq, Remote antenna, RbMap& r
     }
 
     lastUplinkTransmission_ = NOW;
+    markUlTransmissionMapChanged(carrierFreq, CURR_TTI);
 }
 
 void Binder::storeUlTransmissionMap(double carrierFreq, Remote antenna, RbMap& rbMap, MacNodeId nodeId, MacCellId cellId, TrafficGeneratorBase* trafficGen, Direction dir)
@@ -560,6 +583,7 @@ void Binder::storeUlTransmissionMap(double carrierFreq, Remote antenna, RbMap& r
         ulTransmissionMap_[carrierFreq].resize(2);
         ulTransmissionMap_[carrierFreq][PREV_TTI].resize(numCarrierBands);
         ulTransmissionMap_[carrierFreq][CURR_TTI].resize(numCarrierBands);
+        markUlTransmissionMapChanged(carrierFreq, PREV_TTI);
     }
     else if (ulTransmissionMap_[carrierFreq].size() == 1)
     {
@@ -578,6 +602,7 @@ void Binder::storeUlTransmissionMap(double carrierFreq, Remote antenna, RbMap& r
     }
 
     lastUplinkTransmission_ = NOW;
+    markUlTransmissionMapChanged(carrierFreq, CURR_TTI);
 }
 
 
@@ -590,6 +615,39 @@ const std::vector<std::vector<UeAllocationInfo> >* Binder::getUlTransmissionMap(
     return &(ulTransmissionMap_[carrierFreq].at(t));
 }
 
+void Binder::markUlTransmissionMapChanged(double carrierFreq, UlTransmissionMapTTI t)
+{
+    ulTransmissionMapVersion_[std::make_pair(carrierFreq, t)] = ++ulTransmissionMapVersionCounter_;
+}
+
+unsigned long Binder::getUlTransmissionMapVersion(double carrierFreq, UlTransmissionMapTTI t)
+{
+    std::map<std::pair<double, UlTransmissionMapTTI>, unsigned long>::iterator it = ulTransmissionMapVersion_.find(std::make_pair(carrierFreq, t));
+    return (it == ulTransmissionMapVersion_.end()) ? 0 : it->second;
+}
+
+const UlInterferenceInfo* Binder::getUlInterferenceInfo(double carrierFreq, UlTransmissionMapTTI t, MacCellId cellId)
+{
+    UplinkInterferenceMap::iterator it = ulInterferenceMap_.find(std::make_pair(carrierFreq, t));
+    if (it == ulInterferenceMap_.end())
+        return nullptr;
+
+    std::map<MacCellId, UlInterferenceInfo>::iterator jt = it->second.find(cellId);
+    if (jt == it->second.end() || jt->second.version != getUlTransmissionMapVersion(carrierFreq, t))
+        return nullptr;
+
+    return &(jt->second);
+}
+
+const UlInterferenceInfo* Binder::storeUlInterferenceInfo(double carrierFreq, UlTransmissionMapTTI t, MacCellId cellId, std::vector<double>& power, std::set<MacNodeId>& interferers)
+{
+    UlInterferenceInfo& info = ulInterferenceMap_[std::make_pair(carrierFreq, t)][cellId];
+    info.version = getUlTransmissionMapVersion(carrierFreq, t);
+    info.power.swap(power);
+    info.interferers.swap(interferers);
+    return &info;
+}
+
 void Binder::registerX2Port(X2NodeId nodeId, int port)
 {
     if (x2ListeningPorts_.find(nodeId) == x2ListeningPorts_.end() )
@@ -747,6 +805,10 @@ void Binder::registerMulticastGroup(MacNodeId nodeId, int32_t groupId)
     {
         multicastGroupMap_[nodeId].insert(groupId);
     }
+
+    multicastGroupMembers_[groupId].insert(nodeId);
+    // the spatial index of the group must be rebuilt
+    multicastGroupGrid_[groupId].lastUpdate = -1;
 }
 
 bool Binder::isInMulticastGroup(MacNodeId nodeId, int32_t groupId)
@@ -759,6 +821,14 @@ bool Binder::isInMulticastGroup(MacNodeId nodeId, int32_t groupId)
     return true;
 }
 
+const std::set<MacNodeId>* Binder::getMulticastGroupMembers(int32_t groupId)
+{
+    std::map<int32_t, std::set<MacNodeId> >::iterator it = multicastGroupMembers_.find(groupId);
+    if (it == multicastGroupMembers_.end())
+        return nullptr;
+    return &(it->second);
+}
+
 void Binder::addD2DMulticastTransmitter(MacNodeId nodeId)
 {
     multicastTransmitterSet_.insert(nodeId);
@@ -770,17 +840,130 @@ std::set<MacNodeId>& Binder::getD2DMulticastTransmitters()
 }
 
 
-void Binder::updateUeInfoCellId(MacNodeId id, MacCellId newCellId)
+Binder::EnbGrid& Binder::buildEnbGrid(double carrierFrequency, double cellSize)
 {
-    std::vector<UeInfo*>::iterator it = ueList_.begin();
-    for (; it != ueList_.end(); ++it)
+    EnbGrid& grid = enbGrid_[carrierFrequency];
+    grid.cellSize = cellSize;
+    grid.enbCoord.assign(enbList_.size(), inet::Coord::ZERO);
+
+    // retrieve the position of the eNBs using the given carrier
+    std::vector<bool> usesCarrier(enbList_.size(), false);
+    double minX = 0, minY = 0, maxX = 0, maxY = 0;
+    bool first = true;
+    for (unsigned int i = 0; i < enbList_.size(); i++)
     {
-        if ((*it)->id == id)
+        LtePhyBase* phy = check_and_cast<LtePhyBase*>(enbList_[i]->eNodeB->getSubmodule("cellularNic")->getSubmodule("phy"));
+        if (phy->getChannelModel(carrierFrequency) == nullptr)
+            continue;
+
+        usesCarrier[i] = true;
+        grid.enbCoord[i] = phy->getCoord();
+        if (first || grid.enbCoord[i].x < minX)
+            minX = grid.enbCoord[i].x;
+        if (first || grid.enbCoord[i].y < minY)
+            minY = grid.enbCoord[i].y;
+        if (first || grid.enbCoord[i].x > maxX)
+            maxX = grid.enbCoord[i].x;
+        if (first || grid.enbCoord[i].y > maxY)
+            maxY = grid.enbCoord[i].y;
+        first = false;
+    }
+
+    grid.minX = minX;
+    grid.minY = minY;
+    grid.numCellsX = (int)floor((maxX - minX) / cellSize) + 1;
+    grid.numCellsY = (int)floor((maxY - minY) / cellSize) + 1;
+    grid.cells.clear();
+    grid.cells.resize(grid.numCellsX * grid.numCellsY);
+
+    for (unsigned int i = 0; i < enbList_.size(); i++)
+    {
+        if (!usesCarrier[i])
+            continue;
+        int cx = (int)floor((grid.enbCoord[i].x - minX) / cellSize);
+        int cy = (int)floor((grid.enbCoord[i].y - minY) / cellSize);
+        grid.cells[cy * grid.numCellsX + cx].push_back(i);
+    }
+
+    EV << "Binder::buildEnbGrid - carrier [" << carrierFrequency << "GHz] - grid of " << grid.numCellsX << "x" << grid.numCellsY
+       << " cells of size " << cellSize << "m" << endl;
+
+    return grid;
+}
+
+void Binder::getEnbsInRange(double carrierFrequency, const inet::Coord& coord, double range, std::vector<EnbInfo*>& enbs)
+{
+    enbs.clear();
+
+    std::map<double, EnbGrid>::iterator git = enbGrid_.find(carrierFrequency);
+    EnbGrid& grid = (git != enbGrid_.end()) ? git->second : buildEnbGrid(carrierFrequency, range);
+
+    // range of grid cells overlapping the square around coord
+    int minCx = std::max(0, (int)floor((coord.x - range - grid.minX) / grid.cellSize));
+    int maxCx = std::min(grid.numCellsX - 1, (int)floor((coord.x + range - grid.minX) / grid.cellSize));
+    int minCy = std::max(0, (int)floor((coord.y - range - grid.minY) / grid.cellSize));
+    int maxCy = std::min(grid.numCellsY - 1, (int)floor((coord.y + range - grid.minY) / grid.cellSize));
+
+    std::vector<unsigned int> indices;
+    for (int cy = minCy; cy <= maxCy; cy++)
+    {
+        for (int cx = minCx; cx <= maxCx; cx++)
         {
-            (*it)->cellId = newCellId;
-            return;
+            const std::vector<unsigned int>& cell = grid.cells[cy * grid.numCellsX + cx];
+            for (unsigned int i = 0; i < cell.size(); i++)
+            {
+                if (coord.distance(grid.enbCoord[cell[i]]) <= range)
+                    indices.push_back(cell[i]);
+            }
         }
     }
+
+    // keep the same order as the eNB list, so that results do not depend on the grid layout
+    std::sort(indices.begin(), indices.end());
+    for (unsigned int i = 0; i < indices.size(); i++)
+        enbs.push_back(enbList_[indices[i]]);
+}
+
+void Binder::addUeInfo(UeInfo* info)
+{
+    ueList_.push_back(info);
+
+    if (info->id >= ueInfoById_.size())
+        ueInfoById_.resize(info->id + 1, nullptr);
+    ueInfoById_[info->id] = info;
+}
+
+LteRealisticChannelModel* Binder::getUeChannelModel(MacNodeId id, double carrierFrequency)
+{
+    std::vector<LteRealisticChannelModel*>& channelModels = ueChannelModels_[carrierFrequency];
+    if (id < channelModels.size() && channelModels[id] != nullptr)
+        return channelModels[id];
+
+    UeInfo* info = getUeInfo(id);
+    if (info == nullptr || info->phy == nullptr)
+        return nullptr;
+
+    // the channel models are created by the PHY layer during initialization, hence
+    // cache the pointer only when it is available
+    LteChannelModel* model = info->phy->getChannelModel(carrierFrequency);
+    if (model == nullptr)
+        return nullptr;
+
+    LteRealisticChannelModel* channelModel = dynamic_cast<LteRealisticChannelModel*>(model);
+    if (channelModel == nullptr)
+        throw cRuntimeError("Binder::getUeChannelModel - channel model of UE %d is not a LteRealisticChannelModel", id);
+
+    if (id >= channelModels.size())
+        channelModels.resize(id + 1, nullptr);
+    channelModels[id] = channelModel;
+    return channelModel;
+}
+
+void Binder::updateUeInfoCellId(MacNodeId id, MacCellId newCellId)
+{
+    UeInfo* info = getUeInfo(id);
+    if (info != nullptr)
+        info->cellId = newCellId;
 }
 
 void Binder::addUeHandoverTriggered(MacNodeId nodeId)
@@ -19,11 +19,15 @@
 #include <inet/networklayer/common/L3Address.h>
 #include "common/LteCommon.h"
 #include "common/blerCurves/PhyPisaData.h"
+#include "stack/phy/ChannelModel/ShadowingMap.h"
+#include "stack/phy/ChannelModel/PathLossMap.h"
 #include "nodes/ExtCell.h"
 #include "stack/mac/layer/LteMacBase.h"
 #include "stack/backgroundTrafficGenerator/generators/TrafficGeneratorBase.h"
 
 class UeStatsCollector;
+class LteChannelModel;
+class LteRealisticChannelModel;
 
 /**
  * The Binder module has one instance in the whole network.
@@ -62,9 +66,40 @@ class Binder : public omnetpp::cSimpleModule
     // list of all eNBs. Used for inter-cell interference evaluation
     std::vector<EnbInfo*> enbList_;
 
+    // correlated shadowing fields, indexed by the position of the base station
+    std::map<std::pair<double, double>, ShadowingMap> shadowingMaps_;
+
+    // raster path-loss maps, indexed by the position of the base station and the carrier frequency
+    std::map<std::pair<std::pair<double, double>, double>, PathLossMap> pathLossMaps_;
+
+    // spatial index of the eNBs using a given carrier. Used for inter-cell interference evaluation
+    struct EnbGrid
+    {
+        double cellSize;
+        double minX;
+        double minY;
+        int numCellsX;
+        int numCellsY;
+        // for each cell of the grid, the indices (within enbList_) of the eNBs located in that cell
+        std::vector<std::vector<unsigned int> > cells;
+        // position of the eNBs, indexed as enbList_ (eNBs are assumed not to move)
+        std::vector<inet::Coord> enbCoord;
+    };
+    std::map<double, EnbGrid> enbGrid_;
+
+    // build the spatial index of the eNBs using the given carrier
+    EnbGrid& buildEnbGrid(double carrierFrequency, double cellSize);
+
     // list of all UEs. Used for inter-cell interference evaluation
     std::vector<UeInfo*> ueList_;
 
+    // UEs indexed by MacNodeId, for constant-time lookup (nullptr if not registered)
+    std::vector<UeInfo*> ueInfoById_;
+
+    // for each carrier frequency, the channel model of each UE, indexed by MacNodeId
+    typedef std::map<double, std::vector<LteRealisticChannelModel*> > UeChannelModelMap;
+    UeChannelModelMap ueChannelModels_;
+
     // list of all background traffic manager. Used for background UEs CQI computation
     std::vector<BgTrafficManagerInfo*> bgTrafficManagerList_;
 
@@ -108,6 +143,13 @@ class Binder : public omnetpp::cSimpleModule
     omnetpp::simtime_t lastUpdateUplinkTransmissionInfo_;
     // TTI of the last UL transmission (used for optimization purposes, see initAndResetUlTransmissionInfo() )
     omnetpp::simtime_t lastUplinkTransmission_;
+    // for each carrier frequency and for both previous and current TTIs, version of the UL transmission map.
+    // Versions are drawn from a single counter, so that a slot never gets back a version it already had
+    std::map<std::pair<double, UlTransmissionMapTTI>, unsigned long> ulTransmissionMapVersion_;
+    unsigned long ulTransmissionMapVersionCounter_;
+    // for each carrier frequency and for both previous and current TTIs, stores the aggregated interference perceived by each receiving cell
+    typedef std::map<std::pair<double, UlTransmissionMapTTI>, std::map<MacCellId, UlInterferenceInfo> > UplinkInterferenceMap;
+    UplinkInterferenceMap ulInterferenceMap_;
 
     /*
      * X2 Support
@@ -132,6 +174,8 @@ class Binder : public omnetpp::cSimpleModule
     typedef std::set<uint32_t> MulticastGroupIdSet;
     std::map<MacNodeId, MulticastGroupIdSet> multicastGroupMap_;
     std::set<MacNodeId> multicastTransmitterSet_;
+    // members of each multicast group, ordered by MacNodeId
+    std::map<int32_t, std::set<MacNodeId> > multicastGroupMembers_;
 
     /*
      * Handover support
@@ -147,6 +191,25 @@ class Binder : public omnetpp::cSimpleModule
     }
     virtual void finish() override;
 
+  public:
+    /*
+     * Spatial index of the members of a multicast group. Each cell of the grid
+     * has size cellSize and stores the IDs of the members located in that cell.
+     * The grid is filled by the transmitting PHY layers and is valid for the TTI
+     * it has been built in only (lastUpdate)
+     */
+    struct MulticastGroupGrid
+    {
+        omnetpp::simtime_t lastUpdate;
+        double cellSize;
+        std::map<std::pair<int,int>, std::vector<MacNodeId> > cells;
+
+        MulticastGroupGrid() : lastUpdate(-1), cellSize(0) {}
+    };
+
+  private:
+    std::map<int32_t, MulticastGroupGrid> multicastGroupGrid_;
+
   public:
     Binder()
     {
@@ -157,6 +220,7 @@ class Binder : public omnetpp::cSimpleModule
         totalBands_ = 0;
         lastUpdateUplinkTransmissionInfo_ = 0.0;
         lastUplinkTransmission_ = 0.0;
+        ulTransmissionMapVersionCounter_ = 0;
     }
 
     unsigned int getTotalBands()
@@ -182,6 +246,8 @@ class Binder : public omnetpp::cSimpleModule
         for (auto it = ueList_.begin(); it != ueList_.end(); ++it)
             delete (*it);
         ueList_.clear();
+        ueInfoById_.clear();
+        ueChannelModels_.clear();
     }
 
     /**
@@ -489,7 +555,29 @@ class Binder : public omnetpp::cSimpleModule
         return extCellList_[carrierFrequency].size() - 1;
     }
 
-    ExtCellList getExtCellList(double carrierFrequency)
+    // get the correlated shadowing field of the base station located at the given position (empty if not generated yet)
+    ShadowingMap& getShadowingMap(const inet::Coord& bsCoord)
+    {
+        return shadowingMaps_[std::make_pair(bsCoord.x, bsCoord.y)];
+    }
+
+    // get the path-loss map of the base station located at the given position (empty if not loaded or generated yet)
+    PathLossMap& getPathLossMap(const inet::Coord& bsCoord, double carrierFrequency)
+    {
+        return pathLossMaps_[std::make_pair(std::make_pair(bsCoord.x, bsCoord.y), carrierFrequency)];
+    }
+
+    // find the path-loss map of the base station located at the given position (nullptr if not available)
+    const PathLossMap* findPathLossMap(const inet::Coord& bsCoord, double carrierFrequency) const
+    {
+        std::map<std::pair<std::pair<double, double>, double>, PathLossMap>::const_iterator it =
+                pathLossMaps_.find(std::make_pair(std::make_pair(bsCoord.x, bsCoord.y), carrierFrequency));
+        if (it == pathLossMaps_.end() || it->second.empty())
+            return nullptr;
+        return &it->second;
+    }
+
+    const ExtCellList& getExtCellList(double carrierFrequency)
     {
         return extCellList_[carrierFrequency];
     }
@@ -511,6 +599,9 @@ class Binder : public omnetpp::cSimpleModule
     void addEnbInfo(EnbInfo* info)
     {
         enbList_.push_back(info);
+
+        // the spatial index needs to be rebuilt
+        enbGrid_.clear();
     }
 
     std::vector<EnbInfo*> * getEnbList()
@@ -518,11 +609,29 @@ class Binder : public omnetpp::cSimpleModule
         return &enbList_;
     }
 
-    void addUeInfo(UeInfo* info)
+    /**
+     * Fills enbs with the eNBs using the given carrier that are located within the given
+     * distance from coord. eNBs are returned in the same order as in the eNB list
+     */
+    void getEnbsInRange(double carrierFrequency, const inet::Coord& coord, double range, std::vector<EnbInfo*>& enbs);
+
+    void addUeInfo(UeInfo* info);
+
+    /**
+     * Returns the UeInfo of the given UE, or nullptr if the UE is not registered
+     */
+    UeInfo* getUeInfo(MacNodeId id)
     {
-        ueList_.push_back(info);
+        return (id < ueInfoById_.size()) ? ueInfoById_[id] : nullptr;
     }
 
+    /**
+     * Returns the channel model used by the given UE on the given carrier,
+     * or nullptr if the UE is not registered or does not use that carrier.
+     * The channel model must be a LteRealisticChannelModel: it is cast once, when cached
+     */
+    LteRealisticChannelModel* getUeChannelModel(MacNodeId id, double carrierFrequency);
+
     std::vector<UeInfo*> * getUeList()
     {
         return &ueList_;
@@ -550,6 +659,13 @@ class Binder : public omnetpp::cSimpleModule
     void storeUlTransmissionMap(double carrierFreq, Remote antenna, RbMap& rbMap, MacNodeId nodeId, MacCellId cellId, LtePhyBase* phy, Direction dir);
     void storeUlTransmissionMap(double carrierFreq, Remote antenna, RbMap& rbMap, MacNodeId nodeId, MacCellId cellId, TrafficGeneratorBase* trafficGen, Direction dir);  // overloaded function for bgUes
     const std::vector<std::vector<UeAllocationInfo> >* getUlTransmissionMap(double carrierFreq, UlTransmissionMapTTI t);
+    // gives a new version to the UL transmission map of the given carrier and TTI
+    void markUlTransmissionMapChanged(double carrierFreq, UlTransmissionMapTTI t);
+    unsigned long getUlTransmissionMapVersion(double carrierFreq, UlTransmissionMapTTI t);
+    // returns the aggregated UL interference perceived by the given cell, or nullptr if it is not up to date with the UL transmission map
+    const UlInterferenceInfo* getUlInterferenceInfo(double carrierFreq, UlTransmissionMapTTI t, MacCellId cellId);
+    // publishes the aggregated UL interference perceived by the given cell, computed from the current UL transmission map
+    const UlInterferenceInfo* storeUlInterferenceInfo(double carrierFreq, UlTransmissionMapTTI t, MacCellId cellId, std::vector<double>& power, std::set<MacNodeId>& interferers);
     /*
      * X2 Support
      */
@@ -573,6 +689,10 @@ class Binder : public omnetpp::cSimpleModule
     void registerMulticastGroup(MacNodeId nodeId, int32_t groupId);
     // check if the node is enrolled in the group
     bool isInMulticastGroup(MacNodeId nodeId, int32_t groupId);
+    // get the members of the group, ordered by MacNodeId (nullptr if the group has no members)
+    const std::set<MacNodeId>* getMulticastGroupMembers(int32_t groupId);
+    // get the spatial index of the members of the group
+    MulticastGroupGrid& getMulticastGroupGrid(int32_t groupId) { return multicastGroupGrid_[groupId]; }
     // add one multicast transmitter
     void addD2DMulticastTransmitter(MacNodeId nodeId);
     // get multicast transmitters
@@ -26,7 +26,7 @@
 
 #include <iostream>
 
-static double BLER_15_CQI_TU [15][16] = {
+static const double BLER_15_CQI_TU [15][16] = {
 {
  1, 1, 0.996, 0.992, 0.968, 0.88, 0.76, 0.564, 0.364, 0.22, 0.084, 0.044, 0.008, 0, 0.004, 0,
 },
@@ -75,7 +75,7 @@ static double BLER_15_CQI_TU [15][16] = {
 
 };
 
-static double SINR_15_CQI_TU [15][16] = {
+static const double SINR_15_CQI_TU [15][16] = {
 {
  -14.5, -13.5, -12.5, -11.5, -10.5, -9.5, -8.5, -7.5, -6.5, -5.5, -4.5, -3.5, -2.5, -1.5, -0.5, 0.5,
 },
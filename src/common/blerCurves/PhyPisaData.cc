@@ -15,7 +15,9 @@
 
 using namespace omnetpp;
 
-double blerCurvesNew[3][15][49]={
+// the tables are read-only, so that they are kept in the read-only data segment and
+// shared among all the simulation processes running on the same host
+static const double blerCurvesNew[3][15][49]={
         {
                 { 0.7208885924, 0.6364279834, 0.5332800360, 0.4360423440, 0.3666968777, 0.2702148823, 0.2545646762, 0.1872308878, 0.1517548369, 0.1063099811, 0.0748798778, 0.0606737487, 0.0532828620, 0.0387772788, 0.0293569902, 0.0226701188, 0.0184603938, 0.0142304934, 0.0120606390, 0.0082131224, 0.0063205729, 0.0046069027, 0.0037611803, 0.0031393568, 0.0026150711, 0.0017728079, 0.0015719911, 0.0009521393, 0.0009466133, 0.0008233501, 0.0006088240, 0.0004728737, 0.0003828146, 0.0003060003, 0.0002537224, 0.0002230114, 0.0002008010, 0.0001679888, 0.0001355403, 0.0001104041, 0.0000908001, 0.0000655503, 0.0000570788, 0.0000456929, 0.0000365713, 0.0000292649, 0.0000234136, 0.0000187286, 0.0000149782},
 
@@ -144,7 +146,7 @@ double blerCurves[3][8][46]={
         }
     };
 
-double lambdaTable[][3]={{1.597911858997, 0.710313546117, 2.249586633581}, {1.596637792198, 0.495826714440, 3.220152818918}, {1.919399495716, 0.432685156729, 4.436018813830}, {1.783436236411, 0.175433296494, 10.165893659026},
+static const double lambdaTable[][3]={{1.597911858997, 0.710313546117, 2.249586633581}, {1.596637792198, 0.495826714440, 3.220152818918}, {1.919399495716, 0.432685156729, 4.436018813830}, {1.783436236411, 0.175433296494, 10.165893659026},
         {1.601185653216, 0.663524990588, 2.413150485557}, {1.013635204668, 0.400976920537, 2.527914083707}, {3.433005091875, 0.640791622132, 5.357443782507}, {1.729162282384, 0.618298264805, 2.796647477133},
         {1.388369315840, 0.235029187439, 5.907220847614}, {2.321342872213, 0.645022737237, 3.598854332109}, {1.968126135269, 0.715414278598, 2.751029989400}, {2.168855708983, 0.692363418760, 3.132539429749},
         {1.871198920414, 0.446293573842, 4.192753447703}, {1.036764658035, 0.772901393001, 1.341393180841}, {1.470343928566, 0.506973491221, 2.900238284697}, {1.358735351867, 0.231040555268, 5.880938739480},
@@ -2649,8 +2651,8 @@ double lambdaTable[][3]={{1.597911858997, 0.710313546117, 2.249586633581}, {1.59
 PhyPisaData::PhyPisaData()
 {
     // TODO Auto-generated constructor stub
-    memcpy(blerCurves_, blerCurvesNew, sizeof(double) * 3 * 15 * 49);
-    memcpy(lambdaTable_, lambdaTable, sizeof(double) * 10000 * 3);
+    blerCurves_ = blerCurvesNew;
+    lambdaTable_ = lambdaTable;
     channel_.resize(10000);
     double x, y;
     blerShift_ = 0;
@@ -2660,6 +2662,9 @@ PhyPisaData::PhyPisaData()
         y = normal(getEnvir()->getRNG(0), 0, 0.5);
         channel_[i] = (x * x) + (y * y);
     }
+
+    blerTableResolution_ = 1.0;
+    buildBlerTable();
 }
 
 PhyPisaData::~PhyPisaData()
@@ -2672,3 +2677,82 @@ double PhyPisaData::getChannel(unsigned int i)
     i = i % channel_.size();
     return channel_[i];
 }
+
+void PhyPisaData::buildBlerTable()
+{
+    // sample the BLER curves every blerTableResolution_ dB
+    blerTableSize_ = lround((BLER_TABLE_MAX_SNR - BLER_TABLE_MIN_SNR) / blerTableResolution_) + 1;
+    for (int j = 0; j < nMcs(); j++)
+    {
+        blerTable_[j].resize(blerTableSize_);
+        for (int k = 0; k < blerTableSize_; k++)
+            blerTable_[j][k] = GetBLER_TU(BLER_TABLE_MIN_SNR + k * blerTableResolution_, j);
+    }
+
+    // the CQI tables are rebuilt on their next use
+    for (unsigned int t = 0; t < cqiTable_.size(); t++)
+        cqiTable_[t].clear();
+}
+
+void PhyPisaData::setBlerTableResolution(double resolution)
+{
+    if (resolution <= 0 || resolution > BLER_TABLE_MAX_SNR - BLER_TABLE_MIN_SNR)
+        throw cRuntimeError("PhyPisaData::setBlerTableResolution - invalid resolution %f dB", resolution);
+
+    blerTableResolution_ = resolution;
+    buildBlerTable();
+}
+
+unsigned int PhyPisaData::registerTargetBler(double targetBler)
+{
+    for (unsigned int t = 0; t < targetBlers_.size(); t++)
+    {
+        if (targetBlers_[t] == targetBler)
+            return t;
+    }
+    targetBlers_.push_back(targetBler);
+    cqiTable_.push_back(std::vector<int>());
+    return targetBlers_.size() - 1;
+}
+
+const std::vector<int>& PhyPisaData::getCqiTable(unsigned int targetBlerIndex)
+{
+    std::vector<int>& table = cqiTable_.at(targetBlerIndex);
+    if (!table.empty())
+        return table;
+
+    double targetBler = targetBlers_[targetBlerIndex];
+    table.resize(blerTableSize_);
+    for (int k = 0; k < blerTableSize_; k++)
+    {
+        // select the CQI with the BLER closest to the target (the highest one, in case of ties)
+        int found = 0;
+        double low = 2;
+        for (int i = 0; i < nMcs(); i++)
+        {
+            double diff = targetBler - blerTable_[i][k];
+            double min = (diff > 0) ? diff : (diff * -1);
+            if (low >= min)
+            {
+                found = i;
+                low = min;
+            }
+        }
+        table[k] = found + 1;
+    }
+    return table;
+}
+
+int PhyPisaData::getCqi(double snr, unsigned int targetBlerIndex)
+{
+    if (snr < minSnr())
+        return 0;
+    if (snr > maxSnr())
+        return 15;
+
+    // the SINRs within the range may round to one step beyond the last sample
+    int index = getSnrIndex(snr);
+    if (index < 0)
+        index = blerTableSize_ - 1;
+    return getCqiTable(targetBlerIndex)[index];
+}
@@ -14,18 +14,54 @@
 
 #include <string.h>
 #include <vector>
+#include <map>
 #include <iostream>
+#include <cmath>
 
 #include "common/blerCurves/BLERvsSINR_15CQI_TU.h"
 
+// range of the (shifted) SINR values covered by the BLER tables
+#define BLER_TABLE_MIN_SNR -14
+#define BLER_TABLE_MAX_SNR 40
+
 class PhyPisaData
 {
-    double lambdaTable_[10000][3];
-    double blerCurves_[3][15][49];
+    // references to the static tables (not copied, as they are never modified)
+    const double (*lambdaTable_)[3];
+    const double (*blerCurves_)[15][49];
     std::vector<double> channel_;
 
     int blerShift_;
 
+    // SINR step (dB) of the BLER tables
+    double blerTableResolution_;
+    int blerTableSize_;
+
+    /*
+     * BLER curves sampled every blerTableResolution_ dB, indexed as [cqi][getSnrIndex(sinr)].
+     * The curves do not depend on the transmission mode
+     */
+    std::vector<double> blerTable_[15];
+
+    // target BLERs registered by registerTargetBler()
+    std::vector<double> targetBlers_;
+
+    /*
+     * For each registered target BLER, the CQI whose BLER is the closest to the target at each
+     * SINR, indexed as blerTable_. Built on first use of each target BLER
+     */
+    std::vector<std::vector<int> > cqiTable_;
+
+    void buildBlerTable();
+    const std::vector<int>& getCqiTable(unsigned int targetBlerIndex);
+
+    // returns the index of the given SINR in the BLER tables, or -1 if it is out of range
+    int getSnrIndex(double snr) const
+    {
+        long index = lround((snr + blerShift_ - BLER_TABLE_MIN_SNR) / blerTableResolution_);
+        return (index < 0 || index >= blerTableSize_) ? -1 : (int)index;
+    }
+
     public:
     PhyPisaData();
     virtual ~PhyPisaData();
@@ -41,11 +77,36 @@ class PhyPisaData
     //double getBler(int i, int j, int k){if (j==0) return 1; else return blerCurves_[i][j][k-1+blerShift_];}
 //    int minSnr(){return 0-blerShift_;}
 //    int maxSnr(){return 49-blerShift_;}
-    double getBler(int i, int j, int k) { return GetBLER_TU(k+blerShift_, j);};
+    // the SINR should be a multiple of getBlerTableResolution(), otherwise the closest one is used
+    double getBler(int i, int j, double snr)
+    {
+        int index = getSnrIndex(snr);
+        if (index < 0)
+            return GetBLER_TU(snr+blerShift_, j);
+        return blerTable_[j][index];
+    }
     int minSnr(){return -14-blerShift_;}//SINR_15_CQI_TU [0] [0];}
     int maxSnr(){return 40-blerShift_;}//SINR_15_CQI_TU [14] [15];}
 
     void setBlerShift( int shift ) { blerShift_ = shift; }
+
+    /*
+     * Sets the SINR step (dB) of the BLER tables and rebuilds them. Callers quantize
+     * the SINR to this step before looking up the tables (1 dB by default)
+     */
+    void setBlerTableResolution(double resolution);
+    double getBlerTableResolution() const { return blerTableResolution_; }
+
+    /*
+     * Registers a target BLER for getCqi(), and returns its index
+     */
+    unsigned int registerTargetBler(double targetBler);
+
+    /*
+     * Returns the CQI (1-15) whose BLER at the given SINR is the closest to the given registered
+     * target BLER. Returns 0 if the SINR is below minSnr() and 15 if it is above maxSnr()
+     */
+    int getCqi(double snr, unsigned int targetBlerIndex);
     double getChannel(unsigned int i);
 };
 
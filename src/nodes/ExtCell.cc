@@ -50,6 +50,8 @@ void ExtCell::initialize(int stage)
     {
          binder_ = getBinder();
 
+         allocationVersion_ = 0;
+
          // initialize band status structures
          bandStatus_.resize(numBands_, 0);
          prevBandStatus_.resize(numBands_, 0);
@@ -118,6 +120,9 @@ void ExtCell::updateBandStatus()
 {
     EV << "----- EXT CELL ALLOCATION UPDATE -----" << std::endl;
 
+    BandStatus oldBandStatus = bandStatus_;
+    BandStatus oldPrevBandStatus = prevBandStatus_;
+
     resetBandStatus();
 
     if (allocationType_ == RANDOM_ALLOC)
@@ -146,6 +151,10 @@ void ExtCell::updateBandStatus()
         }
     }
 
+    // let the interference caches know that the allocation pattern changed
+    if (bandStatus_ != oldBandStatus || prevBandStatus_ != oldPrevBandStatus)
+        allocationVersion_++;
+
     EV << "----- END EXT CELL ALLOCATION UPDATE -----" << std::endl;
 }
 
@@ -57,6 +57,9 @@ class ExtCell : public omnetpp::cSimpleModule
     BandStatus bandStatus_;
     BandStatus prevBandStatus_;
 
+    // incremented whenever the current or the previous band status changes
+    unsigned long allocationVersion_;
+
     // TTI self message
     omnetpp::cMessage* ttiTick_;
 
@@ -98,9 +101,21 @@ class ExtCell : public omnetpp::cSimpleModule
 
     unsigned int getNumBands() { return numBands_; }
 
-    void setBlock(int band) { bandStatus_.at(band) = 1; }
-
-    void unsetBlock(int band) { bandStatus_.at(band) = 0; }
+    void setBlock(int band)
+    {
+        if (bandStatus_.at(band) != 1)
+            allocationVersion_++;
+        bandStatus_.at(band) = 1;
+    }
+
+    void unsetBlock(int band)
+    {
+        if (bandStatus_.at(band) != 0)
+            allocationVersion_++;
+        bandStatus_.at(band) = 0;
+    }
+
+    unsigned long getAllocationVersion() { return allocationVersion_; }
 
     int getBandStatus(int band) { return bandStatus_.at(band); }
 
@@ -75,6 +75,7 @@ void BackgroundCellTrafficManager::initialize(int stage)
             bgAmc_ = new BackgroundCellAmc();
 
         phyPisaData_ = &(getBinder()->phyPisaData);
+        targetBlerIndex_ = phyPisaData_->registerTargetBler(0.01); // TODO get this from parameters
     }
     if (stage == inet::INITSTAGE_LAST-1)
     {
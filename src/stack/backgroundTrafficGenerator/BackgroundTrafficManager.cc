@@ -66,6 +66,7 @@ void BackgroundTrafficManager::initialize(int stage)
             bgUe_.push_back(check_and_cast<TrafficGeneratorBase*>(getParentModule()->getSubmodule("bgUE", i)->getSubmodule("generator")));
 
         phyPisaData_ = &(getBinder()->phyPisaData);
+        targetBlerIndex_ = phyPisaData_->registerTargetBler(0.01); // TODO get this from parameters
     }
     if (stage == inet::INITSTAGE_PHYSICAL_LAYER)
     {
@@ -202,34 +203,11 @@ Cqi BackgroundTrafficManager::computeCqi(int bgUeIndex, Direction dir, inet::Coo
 
 Cqi BackgroundTrafficManager::computeCqiFromSinr(double sinr)
 {
-    int newsnr = floor(sinr + 0.5);
-    if (newsnr < phyPisaData_->minSnr())
-        return 0;
-    if (newsnr > phyPisaData_->maxSnr())
-        return 15;
+    // round the SINR to the resolution of the BLER tables
+    double resolution = phyPisaData_->getBlerTableResolution();
+    double newsnr = floor(sinr / resolution + 0.5) * resolution;
 
-    unsigned int txm = 1;
-    std::vector<double> min;
-    int found = 0;
-    double low = 2;
-
-    // TODO do this once in the initialize
-    min.resize(phyPisaData_->nMcs(), 2);
-
-    double targetBler = 0.01; // TODO get this from parameters
-
-    for (int i = 0; i < phyPisaData_->nMcs(); i++)
-    {
-        double tmp = phyPisaData_->getBler(txm, i, newsnr);
-        double diff = targetBler - tmp;
-        min[i] = (diff > 0) ? diff : (diff * -1);
-        if (low >= min[i])
-        {
-            found = i;
-            low = min[i];
-        }
-    }
-    return found + 1;
+    return phyPisaData_->getCqi(newsnr, targetBlerIndex_);
 
 //    return getCqiFromTable(sinr);
 }
@@ -50,6 +50,8 @@ class BackgroundTrafficManager : public cSimpleModule
 
     //pointer to pisadata
     PhyPisaData* phyPisaData_;
+    // index of the target BLER in the CQI tables of PhyPisaData
+    unsigned int targetBlerIndex_;
 
     /// TTI for this node
     double ttiPeriod_;
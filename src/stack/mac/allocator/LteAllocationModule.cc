@@ -21,6 +21,7 @@ LteAllocationModule::LteAllocationModule(LteMacEnb *mac, Direction direction)
     dir_ = direction;
     bands_ = 0;
     usedInLastSlot_ = false;
+    prevAllocationValid_ = false;
 }
 
 void LteAllocationModule::init(const unsigned int resourceBlocks, const unsigned int bands)
@@ -42,15 +43,13 @@ void LteAllocationModule::init(const unsigned int resourceBlocks, const unsigned
     // set the available antennas of MAIN plane to 1 (just MACRO antenna)
     allocatedRbsMatrix_.at(MAIN_PLANE).resize(MACRO + 1, 0);
 
-    // clean and copy stored block-allocation info
-    prevAllocatedRbsPerBand_.clear();
-    prevAllocatedRbsPerBand_ = allocatedRbsPerBand_;
-
-    // clear and reinitialize the allocatedBlocks structures and set available planes to 1 (just the main OFDMA space)
-    allocatedRbsPerBand_.clear();
-    allocatedRbsPerBand_.resize(MAIN_PLANE + 1);
-    // set the available antennas of MAIN plane to 1 (just MACRO antenna)
-    allocatedRbsPerBand_.at(MAIN_PLANE).resize(MACRO + 1);
+    // allocate the per-band structures for all the planes and antennas that can be configured later,
+    // so that they are never resized while the simulation is running
+    unsigned int perBandEntries = (MU_MIMO_PLANE + 1) * NUM_ANTENNAS * bands_;
+    allocatedRbsPerBand_.assign(perBandEntries, AllocatedRbsPerBandInfo());
+    prevAllocatedRbsPerBand_.assign(perBandEntries, AllocatedRbsPerBandInfo());
+    // no TTI has been scheduled yet
+    prevAllocationValid_ = false;
 
     // clear and reinitialize the freeResourceBlocks vector and set available planes to 1 (just the main OFDMA space)
     freeRbsMatrix_.clear();
@@ -66,8 +65,26 @@ void LteAllocationModule::init(const unsigned int resourceBlocks, const unsigned
 
 void LteAllocationModule::reset(const unsigned int resourceBlocks, const unsigned int bands)
 {
-    // clean and copy stored block-allocation info
-    prevAllocatedRbsPerBand_ = allocatedRbsPerBand_;
+    // the allocation of the last TTI becomes the previous one. The two planes are swapped rather
+    // than copied: the current plane now holds stale info, which is cleared below
+    allocatedRbsPerBand_.swap(prevAllocatedRbsPerBand_);
+    prevAllocationValid_ = true;
+
+    // clear the allocatedBlocks structures of the configured planes and antennas
+    for (unsigned int plane = 0; plane < totalRbsMatrix_.size(); ++plane)
+    {
+        for (unsigned int antenna = 0; antenna < totalRbsMatrix_[plane].size(); ++antenna)
+        {
+            unsigned int first = bandIndex((Plane) plane, (Remote) antenna, 0);
+            for (unsigned int i = first; i < first + bands_; ++i)
+            {
+                AllocatedRbsPerBandInfo& info = allocatedRbsPerBand_[i];
+                info.ueAllocatedRbsMap_.clear();
+                info.ueAllocatedBytesMap_.clear();
+                info.allocated_ = 0;
+            }
+        }
+    }
 
     // reset structures only if they were used in the previous time slot
     if (usedInLastSlot_)
@@ -94,18 +111,6 @@ void LteAllocationModule::reset(const unsigned int resourceBlocks, const unsigne
         }
 
 
-
-        // clear and reinitialize the allocatedBlocks structures and set available planes to 1 (just the main OFDMA space)
-        std::vector<std::vector<AllocatedRbsPerBandMap> >::iterator plane_jt;
-        std::vector<AllocatedRbsPerBandMap>::iterator antenna_jt;
-        for (plane_jt = allocatedRbsPerBand_.begin(); plane_jt != allocatedRbsPerBand_.end(); ++plane_jt)
-        {
-            for (antenna_jt = plane_jt->begin(); antenna_jt != plane_jt->end(); ++antenna_jt)
-            {
-                antenna_jt->clear();
-            }
-        }
-
         // clear and reinitialize the freeResourceBlocks vector and set available planes to 1 (just the main OFDMA space)
         std::vector<std::vector<std::vector<unsigned int> > >::iterator plane_zt;
         std::vector<std::vector<unsigned int> >::iterator antenna_zt;
@@ -140,9 +145,6 @@ void LteAllocationModule::configureOFDMplane(const Plane plane)
         allocatedRbsMatrix_.resize(plane + 1);
         allocatedRbsMatrix_.at(plane).resize(MACRO + 1);
 
-        allocatedRbsPerBand_.resize(plane + 1);
-        allocatedRbsPerBand_.at(plane).resize(MACRO + 1);
-
         freeRbsMatrix_.resize(plane + 1);
         freeRbsMatrix_.at(plane).resize(MACRO + 1);
         freeRbsMatrix_.at(plane).at(MACRO).resize(bands_, 0);
@@ -160,12 +162,14 @@ void LteAllocationModule::setRemoteAntenna(const Plane plane, const Remote anten
      * Check if antenna already exists in given OFDMA space,
      * otherwise creates all antennas between last one and given one.
      */
+    if (antenna >= NUM_ANTENNAS)
+        throw cRuntimeError("LteAllocationModule::setRemoteAntenna(): Invalid antenna %d", (int) antenna);
+
     for (int i = totalRbsMatrix_.at(plane).size(); i < antenna + 1; ++i)
     {
         // here we have to add missing antennas to the given plane and to set the number of RB for each antenna in this plane
         totalRbsMatrix_.at(plane).resize(i + 1);
         allocatedRbsMatrix_.at(plane).resize(i + 1);
-        allocatedRbsPerBand_.at(plane).resize(i + 1);
         freeRbsMatrix_.at(plane).resize(i + 1);
         freeRbsMatrix_.at(plane).at(i).resize(bands_, 0);
         // initialize new antenna space with macro space
@@ -269,7 +273,7 @@ unsigned int LteAllocationModule::availableBlocks(const MacNodeId nodeId, const
 
     unsigned int blocksPerBand = (totalRbsMatrix_[plane][antenna]) / bands_;
     // blocks allocated in the current band
-    unsigned int allocatedBlocks = allocatedRbsPerBand_[plane][antenna][band].allocated_;
+    unsigned int allocatedBlocks = allocatedRbsPerBand_[bandIndex(plane, antenna, band)].allocated_;
 
     if (blocksPerBand >= allocatedBlocks)
     {
@@ -287,17 +291,39 @@ unsigned int LteAllocationModule::availableBlocks(const MacNodeId nodeId, const
     }
 }
 
+bool LteAllocationModule::readAvailableBlocks(std::vector<unsigned int>& available) const
+{
+    available.clear();
+    for (unsigned int plane = 0; plane < totalRbsMatrix_.size(); ++plane)
+    {
+        for (unsigned int antenna = 0; antenna < totalRbsMatrix_[plane].size(); ++antenna)
+        {
+            unsigned int blocksPerBand = totalRbsMatrix_[plane][antenna] / bands_;
+            unsigned int first = bandIndex((Plane) plane, (Remote) antenna, 0);
+            for (unsigned int i = first; i < first + bands_; ++i)
+            {
+                unsigned int allocatedBlocks = allocatedRbsPerBand_[i].allocated_;
+                available.push_back((blocksPerBand >= allocatedBlocks) ? blocksPerBand - allocatedBlocks : 0);
+            }
+        }
+    }
+    return totalRbsMatrix_.size() == MAIN_PLANE + 1;
+}
+
 unsigned int LteAllocationModule::getAllocatedBlocks(Plane plane, const Remote antenna, const Band band)
 {
-    return allocatedRbsPerBand_[plane][antenna][band].allocated_;
+    if (band >= bands_)
+        return 0;
+    return allocatedRbsPerBand_[bandIndex(plane, antenna, band)].allocated_;
 }
 
 unsigned int LteAllocationModule::getInterferringBlocks(Plane plane, const Remote antenna, const Band band)
 {
-    if (!prevAllocatedRbsPerBand_.empty())
-        return prevAllocatedRbsPerBand_[plane][antenna][band].allocated_;
-    else
+    if (!prevAllocationValid_)
         return 1000;
+    if (band >= bands_)
+        return 0;
+    return prevAllocatedRbsPerBand_[bandIndex(plane, antenna, band)].allocated_;
 }
 
 unsigned int LteAllocationModule::availableBlocks(const MacNodeId nodeId, const Plane plane, const Band band)
@@ -363,9 +389,10 @@ bool LteAllocationModule::addBlocks(const Remote antenna, const Band band, const
     }
 
         // Note the request on the allocator structures
-    allocatedRbsPerBand_[plane][antenna][band].ueAllocatedRbsMap_[nodeId] += blocks;
-    allocatedRbsPerBand_[plane][antenna][band].ueAllocatedBytesMap_[nodeId] += bytes;
-    allocatedRbsPerBand_[plane][antenna][band].allocated_ += blocks;
+    AllocatedRbsPerBandInfo& bandInfo = allocatedRbsPerBand_[bandIndex(plane, antenna, band)];
+    bandInfo.ueAllocatedRbsMap_[nodeId] += blocks;
+    bandInfo.ueAllocatedBytesMap_[nodeId] += bytes;
+    bandInfo.allocated_ += blocks;
 
     allocatedRbsUe_[nodeId].ueAllocatedRbsMap_[antenna][band] += blocks;
     allocatedRbsUe_[nodeId].allocatedBlocks_ += blocks;
@@ -400,19 +427,20 @@ unsigned int LteAllocationModule::removeBlocks(const Remote antenna, const Band
     // retrieving user's plane
     Plane plane = getOFDMPlane(nodeId);
 
-    unsigned int toDrain = allocatedRbsPerBand_[plane][antenna][band].ueAllocatedRbsMap_[nodeId];
+    AllocatedRbsPerBandInfo& bandInfo = allocatedRbsPerBand_[bandIndex(plane, antenna, band)];
+    unsigned int toDrain = bandInfo.ueAllocatedRbsMap_[nodeId];
 
     // If the number of blocks allocated by the nodeId in the band is zero, do nothing!
     if(toDrain == 0)
     return toDrain;
 
     // Note the removal on the allocator structures
-    allocatedRbsPerBand_[plane][antenna][band].allocated_ -= toDrain;
+    bandInfo.allocated_ -= toDrain;
     allocatedRbsUe_[nodeId].allocatedBlocks_-= toDrain;
 
     allocatedRbsUe_[nodeId].ueAllocatedRbsMap_[antenna][band] = 0;
     allocatedRbsUe_[nodeId].allocatedBytes_=0;
-    allocatedRbsPerBand_[plane][antenna][band].ueAllocatedRbsMap_[nodeId] = 0;
+    bandInfo.ueAllocatedRbsMap_[nodeId] = 0;
 
     // drop the allocation list
     allocatedRbsUe_[nodeId].allocationMap_[antenna][band].clear();
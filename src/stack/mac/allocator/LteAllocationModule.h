@@ -167,14 +167,28 @@ class LteAllocationModule
   protected:
 
     /**
-     * e.g. allocatedRbsBand_ [ <plane> ] [ <antenna> ] [ <band> ] give the the amount of blocks allocated for each UE
+     * Per-band allocation info, stored as a flat array with fixed capacity for all the planes
+     * and antennas (see bandIndex()). It is sized once in init(), so that a TTI reset does not
+     * need to reallocate it.
+     *
+     * e.g. allocatedRbsPerBand_ [ bandIndex(<plane>, <antenna>, <band>) ] give the amount of blocks allocated for each UE
      */
-    std::vector<std::vector<AllocatedRbsPerBandMap> > allocatedRbsPerBand_;
+    std::vector<AllocatedRbsPerBandInfo> allocatedRbsPerBand_;
 
     /*
-     * Stores the block-allocation info of the previous TTI in order to use them for interference computation
+     * Stores the block-allocation info of the previous TTI in order to use them for interference computation.
+     * It has the same layout as allocatedRbsPerBand_, and the two planes are swapped at every reset
      */
-    std::vector<std::vector<AllocatedRbsPerBandMap> > prevAllocatedRbsPerBand_;
+    std::vector<AllocatedRbsPerBandInfo> prevAllocatedRbsPerBand_;
+
+    /// Flag that indicates whether prevAllocatedRbsPerBand_ refers to a TTI that has actually been scheduled
+    bool prevAllocationValid_;
+
+    // returns the position of the given (plane, antenna, band) entry within the per-band arrays
+    unsigned int bandIndex(const Plane plane, const Remote antenna, const Band band) const
+    {
+        return ((unsigned int) plane * NUM_ANTENNAS + (unsigned int) antenna) * bands_ + band;
+    }
 
   public:
 
@@ -212,6 +226,10 @@ class LteAllocationModule
 
     // returns the amount of free blocks for the given band and for the fiven antenna
     unsigned int availableBlocks(const MacNodeId nodeId, const Remote antenna, const Band band);
+
+    // writes the amount of free blocks for each configured plane, antenna and band. Returns false
+    // if the amount also depends on the node, i.e. when more than the main OFDMA plane is configured
+    bool readAvailableBlocks(std::vector<unsigned int>& available) const;
     // ***************************************************************
 
     // ************** Resource Blocks Allocation Methods **************
@@ -240,7 +258,7 @@ class LteAllocationModule
     unsigned int getBlocks(const Remote antenna, const Band band, const MacNodeId nodeId)
     {
         Plane plane = allocatedRbsUe_[nodeId].secondaryUser_ ? MU_MIMO_PLANE : MAIN_PLANE;
-        return allocatedRbsPerBand_[plane][antenna][band].ueAllocatedRbsMap_[nodeId];
+        return allocatedRbsPerBand_[bandIndex(plane, antenna, band)].ueAllocatedRbsMap_[nodeId];
     }
 
     /*
@@ -252,7 +270,7 @@ class LteAllocationModule
     unsigned int getBytes(const Remote antenna, const Band band, const MacNodeId nodeId)
     {
         Plane plane = allocatedRbsUe_[nodeId].secondaryUser_ ? MU_MIMO_PLANE : MAIN_PLANE;
-        return allocatedRbsPerBand_[plane][antenna][band].ueAllocatedBytesMap_[nodeId];
+        return allocatedRbsPerBand_[bandIndex(plane, antenna, band)].ueAllocatedBytesMap_[nodeId];
     }
 
     // computes the amount of blocks allocated by the given UE
@@ -44,10 +44,11 @@ void LteAllocationModuleFrequencyReuse::storeAllocation( std::vector<std::vector
             UeAllocatedBytesMapA::iterator it2_ext = allocatedRbsPerBand[plane][antenna][band].ueAllocatedBytesMap_.begin();
             UeAllocatedBytesMapA::iterator et2_ext = allocatedRbsPerBand[plane][antenna][band].ueAllocatedBytesMap_.end();
 
+            AllocatedRbsPerBandInfo& bandInfo = allocatedRbsPerBand_[bandIndex(plane, antenna, band)];
             while(it_ext!=et_ext && it2_ext!=et2_ext)
             {
-                allocatedRbsPerBand_[plane][antenna][band].ueAllocatedRbsMap_[it_ext->first] = it_ext->second;    // Blocks
-                allocatedRbsPerBand_[plane][antenna][band].ueAllocatedBytesMap_[it_ext->first] = it2_ext->second; // Bytes
+                bandInfo.ueAllocatedRbsMap_[it_ext->first] = it_ext->second;    // Blocks
+                bandInfo.ueAllocatedBytesMap_[it_ext->first] = it2_ext->second; // Bytes
 
                 // Creates a pair (a key) for the Map
                 std::pair<MacNodeId,Band> Key_pair (it_ext->first,band);
@@ -59,7 +60,7 @@ void LteAllocationModuleFrequencyReuse::storeAllocation( std::vector<std::vector
                 it2_ext++;
             }
             // Copy the allocatedRbsPerBand
-            allocatedRbsPerBand_[plane][antenna][band].allocated_ = allocatedRbsPerBand[plane][antenna][band].allocated_;
+            bandInfo.allocated_ = allocatedRbsPerBand[plane][antenna][band].allocated_;
 
             if (allocatedRbsPerBand[plane][antenna][band].allocated_ > 0)
                 allocatedRbsMatrix_[MAIN_PLANE][MACRO] ++;
@@ -96,7 +97,7 @@ std::set<Band>  LteAllocationModuleFrequencyReuse::getAllocatorOccupiedBands()
     vectorBand.clear();
     for(unsigned int i=0;i<bands_;i++)
     {
-        if( allocatedRbsPerBand_[MAIN_PLANE][MACRO][i].allocated_>0 ) vectorBand.insert(i);
+        if( allocatedRbsPerBand_[bandIndex(MAIN_PLANE, MACRO, i)].allocated_>0 ) vectorBand.insert(i);
 
     }
     return vectorBand;
@@ -10,6 +10,7 @@
 //
 //
 #include <omnetpp.h>
+#include <algorithm>
 
 #include "stack/mac/amc/LteAmc.h"
 #include "stack/mac/layer/LteMacEnb.h"
@@ -265,6 +266,7 @@ LteAmc& LteAmc::operator=(const LteAmc& other)
     cqiComputationWeight_ = other.cqiComputationWeight_;
     muMimoDlMatrix_ = other.muMimoDlMatrix_;
     muMimoUlMatrix_ = other.muMimoUlMatrix_;
+    txParamsChanges_ = other.txParamsChanges_;
     muMimoD2DMatrix_ = other.muMimoD2DMatrix_;
 
     return *this;
@@ -462,7 +464,10 @@ void LteAmc::pushFeedback(MacNodeId id, Direction dir, LteFeedback fb, double ca
     // delete the old UserTxParam for this <UE_dir_carrierFreq>, so that it will be recomputed next time it's needed
     std::map<double,std::vector<UserTxParams> > *txParams = (dir == DL) ? &dlTxParams_ : (dir == UL) ? &ulTxParams_ : throw cRuntimeError("LteAmc::pushFeedback(): Unrecognized direction");
     if (txParams->find(carrierFrequency) != txParams->end() && txParams->at(carrierFrequency).at(index).isSet())
+    {
         (*txParams)[carrierFrequency].at(index).restoreDefaultValues();
+        markTxParamsChanged(id, dir, carrierFrequency);
+    }
 
     // DEBUG
     EV << "Antenna: " << dasToA(antenna) << ", TxMode: " << txMode << ", Index: " << index << endl;
@@ -503,7 +508,10 @@ void LteAmc::pushFeedbackD2D(MacNodeId id, LteFeedback fb, MacNodeId peerId, dou
 
     // delete the old UserTxParam for this <UE_dir_carrierFreq>, so that it will be recomputed next time it's needed
     if (d2dTxParams_.find(carrierFrequency) != d2dTxParams_.end() && d2dTxParams_.at(carrierFrequency).at(index).isSet())
+    {
         d2dTxParams_[carrierFrequency].at(index).restoreDefaultValues();
+        markTxParamsChanged(id, D2D, carrierFrequency);
+    }
 
 
     // DEBUG
@@ -635,9 +643,34 @@ const UserTxParams& LteAmc::setTxParams(MacNodeId id, const Direction dir, UserT
         tmp.resize(connectedUe.size(), UserTxParams());
         (*txParams)[carrierFrequency] = tmp;
     }
+    markTxParamsChanged(id, dir, carrierFrequency);
     return (*txParams)[carrierFrequency].at(nodeIndex.at(id)) = info;
 }
 
+void LteAmc::markTxParamsChanged(MacNodeId id, Direction dir, double carrierFrequency)
+{
+    std::map<std::pair<Direction, double>, std::set<MacNodeId> >::iterator it = txParamsChanges_.begin();
+    for (; it != txParamsChanges_.end(); ++it)
+    {
+        if (it->first.first == dir && (carrierFrequency < 0 || it->first.second == carrierFrequency))
+            it->second.insert(id);
+    }
+}
+
+void LteAmc::trackTxParamsChanges(Direction dir, double carrierFrequency)
+{
+    txParamsChanges_[std::make_pair(dir, carrierFrequency)];
+}
+
+void LteAmc::drainTxParamsChanges(Direction dir, double carrierFrequency, std::vector<MacNodeId>& changed)
+{
+    std::map<std::pair<Direction, double>, std::set<MacNodeId> >::iterator it = txParamsChanges_.find(std::make_pair(dir, carrierFrequency));
+    if (it == txParamsChanges_.end())
+        return;
+    changed.insert(changed.end(), it->second.begin(), it->second.end());
+    it->second.clear();
+}
+
 const UserTxParams& LteAmc::computeTxParams(MacNodeId id, const Direction dir, double carrierFrequency)
 {
     // DEBUG
@@ -680,7 +713,7 @@ unsigned int LteAmc::computeReqRbs(MacNodeId id, Band b, Codeword cw, unsigned i
 
     // Loading TBS vectors
     const unsigned int* tbsVect;// it is a row of the itbs matrix
-    UserTxParams info = computeTxParams(id, dir,carrierFrequency);
+    const UserTxParams& info = computeTxParams(id, dir,carrierFrequency);
     unsigned char layers = info.getLayers().at(cw);
 
     LteMod mod = info.getCwModulation(cw);
@@ -688,11 +721,9 @@ unsigned int LteAmc::computeReqRbs(MacNodeId id, Band b, Codeword cw, unsigned i
     unsigned int i = (mod == _QPSK ? 0 : (mod == _16QAM ? 9 : (mod == _64QAM ? 15 : 0)));
     tbsVect = itbs2tbs(mod, info.readTxMode(), layers, iTbs-i);
 
-    // Computing RB occupation
-    unsigned int j;
-    for(j = 0; j < 110; ++j)
-    if(tbsVect[j] >= bytes*8)
-    break;
+    // Computing RB occupation: TBS values are non-decreasing with the number of blocks,
+    // hence look for the first entry that can carry the given bits
+    unsigned int j = std::lower_bound(tbsVect, tbsVect + 110, bytes*8) - tbsVect;
 
     // DEBUG
     EV << NOW << " LteAmc::getRbs Occupation: " << bytes << " bytes , CQI : " << info.readCqiVector().at(cw) << " \n";
@@ -754,6 +785,20 @@ unsigned int LteAmc::computeBitsOnNRbs(MacNodeId id, Band b, unsigned int blocks
     return bits;
 }
 
+const unsigned int* LteAmc::readTbsTable(const UserTxParams& info, Codeword cw, const Direction dir, double carrierFrequency, unsigned int& maxBlocks)
+{
+    maxBlocks = 110;
+
+    LteMod mod = info.getCwModulation(cw);
+    unsigned int iTbs = getItbsPerCqi(info.readCqiVector().at(cw), dir);
+    unsigned int i = (mod == _QPSK ? 0 : (mod == _16QAM ? 9 : (mod == _64QAM ? 15 : 0)));
+
+    // the table replaces the computeBitsOnNRbs() calls of the connection, which emit the iTbs
+    mac_->emitItbs(iTbs);
+
+    return itbs2tbs(mod, info.readTxMode(), info.getLayers().at(cw), iTbs - i);
+}
+
 unsigned int LteAmc::computeBitsOnNRbs(MacNodeId id, Band b, Codeword cw, unsigned int blocks, const Direction dir, double carrierFrequency)
 {
     if (blocks > 110)    // Safety check to avoid segmentation fault
@@ -769,7 +814,7 @@ unsigned int LteAmc::computeBitsOnNRbs(MacNodeId id, Band b, Codeword cw, unsign
     EV << NOW << " LteAmc::blocks2bits Direction: " << dirToA(dir) << "\n";
 
     // Acquiring current user scheduling information
-    UserTxParams info = computeTxParams(id, dir,carrierFrequency);
+    const UserTxParams& info = computeTxParams(id, dir,carrierFrequency);
 
     // if CQI == 0 the UE is out of range, thus return 0
     if (info.readCqiVector().at(cw) == 0)
@@ -859,7 +904,7 @@ unsigned int LteAmc::computeBitsOnNRbs_MB(MacNodeId id, Band b,  unsigned int bl
     Cqi cqi = readMultiBandCqi(id,dir,carrierFrequency)[b];
 
     // Acquiring current user scheduling information
-    UserTxParams info = computeTxParams(id, dir,carrierFrequency);
+    const UserTxParams& info = computeTxParams(id, dir,carrierFrequency);
 
     std::vector<unsigned char> layers = info.getLayers();
 
@@ -1345,6 +1390,7 @@ void LteAmc::detachUser(MacNodeId nodeId, Direction dir)
         {
             cit->second.at(nodeIndex).restoreDefaultValues();
         }
+        markTxParamsChanged(nodeId, dir, -1.0);
     }
     catch(std::exception& e)
     {
@@ -1424,6 +1470,7 @@ void LteAmc::attachUser(MacNodeId nodeId, Direction dir)
         {
             cit->second.at(nodeIndex).restoreDefaultValues();
         }
+        markTxParamsChanged(nodeId, dir, -1.0);
 
         // initialize empty feedback structures
         if (dir == UL || dir == DL)
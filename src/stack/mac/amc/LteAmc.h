@@ -97,8 +97,17 @@ class LteAmc
     LteMuMimoMatrix muMimoUlMatrix_;
     LteMuMimoMatrix muMimoD2DMatrix_;
 
+    /*
+     * Nodes whose transmission parameters were set or invalidated since the last drain, kept only
+     * for the <direction, carrier> pairs registered via trackTxParamsChanges()
+     */
+    std::map<std::pair<Direction, double>, std::set<MacNodeId> > txParamsChanges_;
+
     History_* getHistory(Direction dir, double carrierFrequency);
 
+    // records a change of the transmission parameters of the given node (on all carriers if carrierFrequency < 0)
+    void markTxParamsChanged(MacNodeId id, Direction dir, double carrierFrequency);
+
     public:
     LteAmc(LteMacEnb *mac, Binder *binder, CellInfo *cellInfo, int numAntennas);
     LteAmc(const LteAmc& other) { operator=(other); }
@@ -137,6 +146,14 @@ class LteAmc
     const UserTxParams & getTxParams(MacNodeId id, const Direction dir, double carrierFrequency);
     const UserTxParams & setTxParams(MacNodeId id, const Direction dir, UserTxParams & info, double carrierFrequency);
     const UserTxParams & computeTxParams(MacNodeId id, const Direction dir, double carrierFrequency);
+
+    /*
+     * Change tracking of the transmission parameters, used by incremental schedulers.
+     * After trackTxParamsChanges(), every node whose parameters for <dir, carrierFrequency> are set
+     * or invalidated is recorded, and drainTxParamsChanges() returns (and forgets) these nodes
+     */
+    void trackTxParamsChanges(Direction dir, double carrierFrequency);
+    void drainTxParamsChanges(Direction dir, double carrierFrequency, std::vector<MacNodeId>& changed);
     virtual unsigned int computeReqRbs(MacNodeId id, Band b, Codeword cw, unsigned int bytes, const Direction dir, double carrierFrequency);
     virtual unsigned int computeBitsOnNRbs(MacNodeId id, Band b, unsigned int blocks, const Direction dir, double carrierFrequency);
     virtual unsigned int computeBitsOnNRbs(MacNodeId id, Band b, Codeword cw, unsigned int blocks, const Direction dir, double carrierFrequency);
@@ -145,6 +162,13 @@ class LteAmc
 
     virtual unsigned int computeBitsPerRbBackground(Cqi cqi, const Direction dir, double carrierFrequency);
 
+    /*
+     * Returns the table of the bits carried by codeword <cw> of a user with transmission parameters <info>
+     * (i.e. tbs[blocks-1] is the amount of bits carried by <blocks> blocks), and writes its size in <maxBlocks>.
+     * As computeBitsOnNRbs(), it emits the iTbs signal of the codeword (LTE only)
+     */
+    virtual const unsigned int* readTbsTable(const UserTxParams& info, Codeword cw, const Direction dir, double carrierFrequency, unsigned int& maxBlocks);
+
     // multiband version of the above function. It returns the number of bytes that can fit in the given "blocks" of the given "band"
     virtual unsigned int computeBytesOnNRbs_MB(MacNodeId id, Band b, unsigned int blocks, const Direction dir, double carrierFrequency);
     virtual unsigned int computeBitsOnNRbs_MB(MacNodeId id, Band b, unsigned int blocks, const Direction dir, double carrierFrequency);
@@ -10,6 +10,7 @@
 //
 
 #include "stack/mac/amc/NRAmc.h"
+#include <algorithm>
 
 using namespace std;
 using namespace omnetpp;
@@ -91,32 +92,30 @@ unsigned int NRAmc::computeTbsFromNinfo(double nInfo, double coderate)
     {
         unsigned int C;
         n = floor( log2(nInfo - 24) - 5);
-        _nInfo = ( 1 << n ) * round( (nInfo - 24) / (1 << n));
+        _nInfo = std::max(3840u, (unsigned int)(( 1 << n ) * round( (nInfo - 24) / (1 << n))));
         if (coderate <= 0.25 )
         {
-            C = ceil( (_nInfo+24) / 3816 );
-            tbs = 8 * C * ceil( (_nInfo+24) / (8*C) ) - 24;
+            C = ceil( (_nInfo+24) / 3816.0 );
+            tbs = 8 * C * ceil( (_nInfo+24) / (8.0*C) ) - 24;
         }
         else
         {
             if (_nInfo >= 8424)
             {
-                C = ceil( (_nInfo+24) / 8424 );
-                tbs = 8 * C * ceil( (_nInfo+24) / (8*C) ) - 24;
+                C = ceil( (_nInfo+24) / 8424.0 );
+                tbs = 8 * C * ceil( (_nInfo+24) / (8.0*C) ) - 24;
             }
             else
             {
-                tbs = 8 * ceil( (_nInfo+24) / 8 ) - 24;
+                tbs = 8 * ceil( (_nInfo+24) / 8.0 ) - 24;
             }
         }
     }
     return tbs;
 }
 
-unsigned int NRAmc::computeCodewordTbs(UserTxParams* info, Codeword cw, Direction dir, unsigned int numRe)
+unsigned int NRAmc::computeTbs(const NRMCSelem& mcsElem, unsigned char layers, unsigned int numRe)
 {
-    std::vector<unsigned char> layers = info->getLayers();
-    NRMCSelem mcsElem = getMcsElemPerCqi(info->readCqiVector().at(cw), dir);
     unsigned int modFactor;
     switch(mcsElem.mod_)
     {
@@ -127,11 +126,47 @@ unsigned int NRAmc::computeCodewordTbs(UserTxParams* info, Codeword cw, Directio
         default: throw cRuntimeError("NRAmc::computeCodewordTbs - unrecognized modulation.");
     }
     double coderate = mcsElem.coderate_ / 1024;
-    double nInfo = numRe * coderate * modFactor * layers.at(cw);
+    double nInfo = numRe * coderate * modFactor * layers;
 
     return computeTbsFromNinfo(floor(nInfo),coderate);
 }
 
+unsigned int NRAmc::computeCodewordTbs(const UserTxParams& info, Codeword cw, Direction dir, unsigned int numRe)
+{
+    NRMCSelem mcsElem = getMcsElemPerCqi(info.readCqiVector().at(cw), dir);
+    return computeTbs(mcsElem, info.getLayers().at(cw), numRe);
+}
+
+const NRAmc::TbsTable& NRAmc::getTbsTable(Cqi cqi, Direction dir, unsigned char layers, unsigned int symbolsPerSlot)
+{
+    // the MCS is selected from the DL table or from the UL one (see getMcsElemPerCqi)
+    unsigned int mcsTableIndex = (dir == DL) ? 0 : 1;
+    unsigned int key = ((mcsTableIndex * 256 + cqi) * 256 + layers) * 256 + symbolsPerSlot;
+
+    std::map<unsigned int, TbsTable>::iterator it = tbsTables_.find(key);
+    if (it != tbsTables_.end())
+        return it->second;
+
+    // TBS grows with the number of blocks, hence the table can be binary-searched for the first
+    // number of blocks whose TBS carries a given amount of bits
+    NRMCSelem mcsElem = getMcsElemPerCqi(cqi, dir);
+    TbsTable& table = tbsTables_[key];
+    table.tbs_.resize(NR_MAX_BLOCKS);
+    for (unsigned int blocks = 1; blocks <= NR_MAX_BLOCKS; ++blocks)
+        table.tbs_[blocks - 1] = computeTbs(mcsElem, layers, getResourceElements(blocks, symbolsPerSlot));
+
+    return table;
+}
+
+unsigned int NRAmc::computeCodewordTbsOnNRbs(const UserTxParams& info, Codeword cw, Direction dir, unsigned int blocks, unsigned int symbolsPerSlot)
+{
+    if (blocks > NR_MAX_BLOCKS)
+        return computeCodewordTbs(info, cw, dir, getResourceElements(blocks, symbolsPerSlot));
+
+    const TbsTable& table = getTbsTable(info.readCqiVector().at(cw), dir, info.getLayers().at(cw), symbolsPerSlot);
+    return table.tbs_[blocks - 1];
+}
+
 
 /*******************************************
  *      Scheduler interface functions      *
@@ -151,16 +186,23 @@ unsigned int NRAmc::computeReqRbs(MacNodeId id, Band b, Codeword cw, unsigned in
     }
 
     // Acquiring current user scheduling information
-    UserTxParams info = computeTxParams(id, dir,carrierFrequency);
+    const UserTxParams& info = computeTxParams(id, dir,carrierFrequency);
 
     unsigned int bits = bytes * 8;
-    unsigned int numRe = getResourceElements(1, getSymbolsPerSlot(carrierFrequency, dir));
+    const std::vector<unsigned int>& tbs = getTbsTable(info.readCqiVector().at(cw), dir, info.getLayers().at(cw),
+        getSymbolsPerSlot(carrierFrequency, dir)).tbs_;
 
-     // Computing RB occupation
-    unsigned int j = 0;
-    for(j = 0; j < 110; ++j)   // TODO check number of blocks
-        if(computeCodewordTbs(&info, cw, dir, numRe) >= bits)
-            break;
+    // Computing RB occupation: look for the first number of blocks whose TBS can carry the given bits
+    unsigned int j = std::lower_bound(tbs.begin(), tbs.end(), bits) - tbs.begin();
+
+    // even the largest allocation cannot carry the given bits: report the largest allocation,
+    // i.e. NR_MAX_BLOCKS blocks, since no carrier can grant more than that. This is not expected,
+    // as the schedulers only ask for the bytes that fit in the blocks available on the band
+    if (j == tbs.size())
+    {
+        EV << NOW << " NRAmc::computeReqRbs " << bytes << " bytes do not fit in " << NR_MAX_BLOCKS << " blocks\n";
+        j = NR_MAX_BLOCKS - 1;
+    }
 
     // DEBUG
     EV << NOW << " NRAmc::computeReqRbs Occupation: " << bytes << " bytes , CQI : " << info.readCqiVector().at(cw) << " \n";
@@ -179,10 +221,10 @@ unsigned int NRAmc::computeBitsOnNRbs(MacNodeId id, Band b, unsigned int blocks,
     EV << NOW << " NRAmc::computeBitsOnNRbs Band: " << b << "\n";
     EV << NOW << " NRAmc::computeBitsOnNRbs Direction: " << dirToA(dir) << "\n";
 
-    unsigned int numRe = getResourceElements(blocks, getSymbolsPerSlot(carrierFrequency, dir));
+    unsigned int symbolsPerSlot = getSymbolsPerSlot(carrierFrequency, dir);
 
     // Acquiring current user scheduling information
-    UserTxParams info = computeTxParams(id, dir,carrierFrequency);
+    const UserTxParams& info = computeTxParams(id, dir,carrierFrequency);
 
     unsigned int bits = 0;
     unsigned int codewords = info.getLayers().size();
@@ -195,7 +237,7 @@ unsigned int NRAmc::computeBitsOnNRbs(MacNodeId id, Band b, unsigned int blocks,
             continue;
         }
 
-        unsigned int tbs = computeCodewordTbs(&info, cw, dir, numRe);
+        unsigned int tbs = computeCodewordTbsOnNRbs(info, cw, dir, blocks, symbolsPerSlot);
         bits += tbs;
     }
 
@@ -217,10 +259,10 @@ unsigned int NRAmc::computeBitsOnNRbs(MacNodeId id, Band b, Codeword cw, unsigne
     EV << NOW << " NRAmc::computeBitsOnNRbs Codeword: " << cw << "\n";
     EV << NOW << " NRAmc::computeBitsOnNRbs Direction: " << dirToA(dir) << "\n";
 
-    unsigned int numRe = getResourceElements(blocks, getSymbolsPerSlot(carrierFrequency, dir));
+    unsigned int symbolsPerSlot = getSymbolsPerSlot(carrierFrequency, dir);
 
     // Acquiring current user scheduling information
-    UserTxParams info = computeTxParams(id, dir,carrierFrequency);
+    const UserTxParams& info = computeTxParams(id, dir,carrierFrequency);
 
     // if CQI == 0 the UE is out of range, thus return 0
     if (info.readCqiVector().at(cw) == 0)
@@ -229,7 +271,7 @@ unsigned int NRAmc::computeBitsOnNRbs(MacNodeId id, Band b, Codeword cw, unsigne
         return 0;
     }
 
-    unsigned int tbs = computeCodewordTbs(&info, cw, dir, numRe);
+    unsigned int tbs = computeCodewordTbsOnNRbs(info, cw, dir, blocks, symbolsPerSlot);
 
     // DEBUG
     EV << NOW << " NRAmc::computeBitsOnNRbs Resource Blocks: " << blocks << "\n";
@@ -238,6 +280,15 @@ unsigned int NRAmc::computeBitsOnNRbs(MacNodeId id, Band b, Codeword cw, unsigne
     return tbs;
 }
 
+const unsigned int* NRAmc::readTbsTable(const UserTxParams& info, Codeword cw, const Direction dir, double carrierFrequency, unsigned int& maxBlocks)
+{
+    // larger allocations are computed by computeCodewordTbs()
+    maxBlocks = NR_MAX_BLOCKS;
+
+    const TbsTable& table = getTbsTable(info.readCqiVector().at(cw), dir, info.getLayers().at(cw), getSymbolsPerSlot(carrierFrequency, dir));
+    return &table.tbs_[0];
+}
+
 unsigned int NRAmc::computeBitsPerRbBackground(Cqi cqi, const Direction dir, double carrierFrequency)
 {
     // DEBUG
@@ -253,23 +304,8 @@ unsigned int NRAmc::computeBitsPerRbBackground(Cqi cqi, const Direction dir, dou
     unsigned int blocks = 1;
     unsigned char layers = 1;
 
-    // compute TBS
-
-    NRMCSelem mcsElem = getMcsElemPerCqi(cqi, dir);
-    unsigned int numRe = getResourceElements(blocks, getSymbolsPerSlot(carrierFrequency, dir));
-    unsigned int modFactor;
-    switch(mcsElem.mod_)
-    {
-        case _QPSK:   modFactor = 2; break;
-        case _16QAM:  modFactor = 4; break;
-        case _64QAM:  modFactor = 6; break;
-        case _256QAM: modFactor = 8; break;
-        default: throw cRuntimeError("NRAmc::computeCodewordTbs - unrecognized modulation.");
-    }
-    double coderate = mcsElem.coderate_ / 1024;
-    double nInfo = numRe * coderate * modFactor * layers;
-
-    unsigned int tbs = computeTbsFromNinfo(floor(nInfo),coderate);
+    // read TBS from the table
+    unsigned int tbs = getTbsTable(cqi, dir, layers, getSymbolsPerSlot(carrierFrequency, dir)).tbs_[blocks - 1];
 
     EV << NOW << " NRAmc::computeBitsPerRbBackground Available space: " << tbs << "\n";
 
@@ -30,7 +30,25 @@ class NRAmc : public LteAmc
     unsigned int getResourceElements(unsigned int blocks, unsigned int symbolsPerSlot);
     unsigned int computeTbsFromNinfo(double nInfo, double coderate);
 
-    unsigned int computeCodewordTbs(UserTxParams* info, Codeword cw, Direction dir, unsigned int numRe);
+    unsigned int computeTbs(const NRMCSelem& mcsElem, unsigned char layers, unsigned int numRe);
+    unsigned int computeCodewordTbs(const UserTxParams& info, Codeword cw, Direction dir, unsigned int numRe);
+
+    /*
+     * TBS tables, built on first use for a given combination of MCS (i.e., CQI and MCS table),
+     * number of layers and symbols per slot. They only depend on these parameters, hence they
+     * are shared by all the UEs and never need to be invalidated when the UE's tx params change.
+     */
+    static const unsigned int NR_MAX_BLOCKS = 275;
+    struct TbsTable
+    {
+        // TBS for 1..NR_MAX_BLOCKS blocks (non-decreasing)
+        std::vector<unsigned int> tbs_;
+    };
+    std::map<unsigned int, TbsTable> tbsTables_;
+    const TbsTable& getTbsTable(Cqi cqi, Direction dir, unsigned char layers, unsigned int symbolsPerSlot);
+
+    // returns the TBS of the given codeword on the given number of blocks
+    unsigned int computeCodewordTbsOnNRbs(const UserTxParams& info, Codeword cw, Direction dir, unsigned int blocks, unsigned int symbolsPerSlot);
 
   public:
 
@@ -46,6 +64,7 @@ class NRAmc : public LteAmc
     virtual unsigned int computeReqRbs(MacNodeId id, Band b, Codeword cw, unsigned int bytes, const Direction dir, double carrierFrequency);
     virtual unsigned int computeBitsOnNRbs(MacNodeId id, Band b, unsigned int blocks, const Direction dir, double carrierFrequency);
     virtual unsigned int computeBitsOnNRbs(MacNodeId id, Band b, Codeword cw, unsigned int blocks, const Direction dir, double carrierFrequency);
+    virtual const unsigned int* readTbsTable(const UserTxParams& info, Codeword cw, const Direction dir, double carrierFrequency, unsigned int& maxBlocks);
 //    virtual unsigned int computeBytesOnNRbs(MacNodeId id, Band b, unsigned int blocks, const Direction dir, double carrierFrequency);
 //    virtual unsigned int computeBytesOnNRbs(MacNodeId id, Band b, Codeword cw, unsigned int blocks, const Direction dir, double carrierFrequency);
 
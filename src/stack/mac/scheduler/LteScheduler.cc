@@ -20,6 +20,7 @@ void LteScheduler::setEnbScheduler(LteSchedulerEnb* eNbScheduler)
     eNbScheduler_ = eNbScheduler;
     direction_ = eNbScheduler_->direction_;
     mac_ = eNbScheduler_->mac_;
+    incrementalScoring_ = mac_->par("incrementalScoring").boolValue();
 }
 
 void LteScheduler::setCarrierFrequency(double carrierFrequency)
@@ -196,8 +197,12 @@ void LteScheduler::schedule()
 {
     activeConnectionSet_ = eNbScheduler_->readActiveConnections();
 
-    // obtain the list of cids that can be scheduled on this carrier
-    buildCarrierActiveConnectionSet();
+    // obtain the list of cids that can be scheduled on this carrier. With incremental
+    // scoring, the connections of this carrier are tracked through notifications instead
+    if (incrementalScoring_)
+        initializeScoreTracking();
+    else
+        buildCarrierActiveConnectionSet();
 
     // scheduling
     prepareSchedule();
@@ -222,3 +227,309 @@ void LteScheduler::buildCarrierActiveConnectionSet()
             carrierActiveConnectionSet_.insert(*it);
     }
 }
+
+void LteScheduler::notifyActiveConnection(MacCid activeCid)
+{
+    if (incrementalScoring_ && scoreTrackingInitialized_)
+        trackConnection(activeCid);
+}
+
+void LteScheduler::notifyInactiveConnection(MacCid cid)
+{
+    if (incrementalScoring_)
+        untrackConnection(cid);
+}
+
+Direction LteScheduler::getConnectionDirection(MacCid cid) const
+{
+    // if we are allocating the UL subframe, this connection may be either UL or D2D
+    if (direction_ == UL)
+        return (MacCidToLcid(cid) == D2D_SHORT_BSR) ? D2D : (MacCidToLcid(cid) == D2D_MULTI_SHORT_BSR) ? D2D_MULTI : direction_;
+    return DL;
+}
+
+void LteScheduler::initializeScoreTracking()
+{
+    if (scoreTrackingInitialized_)
+        return;
+    scoreTrackingInitialized_ = true;
+
+    if (binder_ == nullptr)
+        binder_ = getBinder();
+    numBands_ = mac_->getCellInfo()->getNumBands();
+
+    // from now on, the AMC records the nodes whose transmission parameters change
+    LteAmc* amc = mac_->getAmc();
+    if (direction_ == DL)
+        amc->trackTxParamsChanges(DL, carrierFrequency_);
+    else
+    {
+        amc->trackTxParamsChanges(UL, carrierFrequency_);
+        amc->trackTxParamsChanges(D2D, carrierFrequency_);
+    }
+
+    ActiveSet::iterator it = activeConnectionSet_->begin();
+    for (; it != activeConnectionSet_->end(); ++it)
+        trackConnection(*it);
+}
+
+void LteScheduler::trackConnection(MacCid cid)
+{
+    if (scoreSlot_.find(cid) != scoreSlot_.end())
+        return;
+
+    // only connections whose UE is enabled to use this carrier are scheduled here
+    const UeSet& carrierUeSet = binder_->getCarrierUeSet(carrierFrequency_);
+    if (carrierUeSet.find(MacCidToNodeId(cid)) == carrierUeSet.end())
+        return;
+
+    unsigned int slot;
+    if (!freeScoreSlots_.empty())
+    {
+        slot = freeScoreSlots_.back();
+        freeScoreSlots_.pop_back();
+    }
+    else
+    {
+        slot = scoreState_.size();
+        scoreState_.push_back(ScoreState());
+    }
+
+    ScoreState& state = scoreState_[slot];
+    state = ScoreState();
+    state.cid_ = cid;
+    state.tracked_ = true;
+    scoreSlot_[cid] = slot;
+
+    connectionTracked(slot);
+    markScoreDirty(slot);
+}
+
+void LteScheduler::untrackConnection(MacCid cid)
+{
+    std::map<MacCid, unsigned int>::iterator it = scoreSlot_.find(cid);
+    if (it == scoreSlot_.end())
+        return;
+
+    unsigned int slot = it->second;
+    connectionUntracked(slot);
+
+    // a dirty slot is skipped when the dirty list is processed
+    scoreState_[slot].tracked_ = false;
+    if (!scoreState_[slot].dirty_)
+        freeScoreSlots_.push_back(slot);
+    scoreSlot_.erase(it);
+}
+
+void LteScheduler::markScoreDirty(unsigned int slot)
+{
+    ScoreState& state = scoreState_[slot];
+    if (state.dirty_)
+        return;
+    state.dirty_ = true;
+    dirtySlots_.push_back(slot);
+}
+
+void LteScheduler::collectScoreChanges()
+{
+    // connections of the nodes with new transmission parameters. The identifiers of the
+    // connections of a node are contiguous, so they are found with a range search
+    changedNodes_.clear();
+    LteAmc* amc = mac_->getAmc();
+    if (direction_ == DL)
+        amc->drainTxParamsChanges(DL, carrierFrequency_, changedNodes_);
+    else
+    {
+        amc->drainTxParamsChanges(UL, carrierFrequency_, changedNodes_);
+        amc->drainTxParamsChanges(D2D, carrierFrequency_, changedNodes_);
+    }
+    for (unsigned int i = 0; i < changedNodes_.size(); ++i)
+    {
+        std::map<MacCid, unsigned int>::iterator it = scoreSlot_.lower_bound(idToMacCid(changedNodes_[i], 0));
+        for (; it != scoreSlot_.end() && MacCidToNodeId(it->first) == changedNodes_[i]; ++it)
+            markScoreDirty(it->second);
+    }
+
+    // the number of bytes depends on the blocks available at the beginning of the TTI, which
+    // change only when retransmissions or previous carriers used some blocks
+    bool uniform = eNbScheduler_->readAvailableRbsSnapshot(availableRbsBuffer_);
+    if (!uniform || !availableRbsUniform_ || availableRbsBuffer_ != availableRbsSnapshot_)
+    {
+        for (unsigned int slot = 0; slot < scoreState_.size(); ++slot)
+        {
+            if (scoreState_[slot].tracked_)
+                markScoreDirty(slot);
+        }
+        availableRbsSnapshot_.swap(availableRbsBuffer_);
+    }
+    availableRbsUniform_ = uniform;
+}
+
+bool LteScheduler::gatherScoreInput(unsigned int slot, ScoreInput& input)
+{
+    ScoreState& state = scoreState_[slot];
+    state.dirty_ = false;
+    state.scorable_ = false;
+
+    MacNodeId nodeId = MacCidToNodeId(state.cid_);
+    if (nodeId == 0 || binder_->getOmnetId(nodeId) == 0)
+    {
+        // node has left the simulation - erase corresponding CIDs
+        eNbScheduler_->removeActiveConnection(state.cid_);
+        return false;
+    }
+
+    Direction dir = getConnectionDirection(state.cid_);
+    LteAmc* amc = eNbScheduler_->mac_->getAmc();
+    const UserTxParams& info = amc->computeTxParams(nodeId, dir, carrierFrequency_);
+    unsigned int codeword = info.getLayers().size();
+    if (codeword > MAX_CODEWORDS)
+        return false;
+    for (unsigned int i = 0; i < codeword; i++)
+    {
+        if (info.readCqiVector()[i] == 0)
+            return false;
+    }
+    state.codewords_ = codeword;
+
+    // the AMC keeps the transmission parameters in per-carrier vectors that are resized only
+    // when users attach, hence the reference is valid until the scores are committed
+    input.slot_ = slot;
+    input.dir_ = dir;
+    input.info_ = &info;
+    input.codewords_ = codeword;
+    input.maxBlocks_ = 0;
+    for (unsigned int i = 0; i < codeword; i++)
+    {
+        unsigned int maxBlocks;
+        input.tbs_[i] = amc->readTbsTable(info, i, dir, carrierFrequency_, maxBlocks);
+        if (i == 0 || maxBlocks < input.maxBlocks_)
+            input.maxBlocks_ = maxBlocks;
+    }
+    input.computed_ = false;
+    return true;
+}
+
+void LteScheduler::computeScoreInput(ScoreInput& input) const
+{
+    // the available blocks are read from the snapshot taken at the beginning of the TTI,
+    // which holds the ones of the main plane for each antenna and band
+    if (!availableRbsUniform_)
+        return;
+
+    const UserTxParams& info = *input.info_;
+    const std::set<Band>& bands = info.readBands();
+    std::set<Band>::const_iterator it = bands.begin(), et = bands.end();
+    std::set<Remote>::const_iterator antennaIt = info.readAntennaSet().begin(), antennaEt = info.readAntennaSet().end();
+
+    // bands are visited as in the score computation of the schedulers, i.e. only for the first antenna
+    unsigned int blocks = 0;
+    unsigned int bytes = 0;
+    for (; antennaIt != antennaEt; ++antennaIt)
+    {
+        unsigned int first = (unsigned int) (*antennaIt) * numBands_;
+        if (first + numBands_ > availableRbsSnapshot_.size())
+            return;
+        for (; it != et; ++it)
+        {
+            if (*it >= numBands_)
+                return;
+            blocks += availableRbsSnapshot_[first + *it];
+            if (blocks > input.maxBlocks_)
+                return;
+
+            // same as LteAmc::computeBytesOnNRbs()
+            unsigned int bits = 0;
+            if (blocks > 0)
+            {
+                for (unsigned int cw = 0; cw < input.codewords_; cw++)
+                    bits += input.tbs_[cw][blocks - 1];
+            }
+            bytes += bits / 8;
+        }
+    }
+
+    input.blocks_ = blocks;
+    input.bytes_ = bytes;
+    input.computed_ = true;
+}
+
+void LteScheduler::computeScoreInputByAmc(ScoreInput& input)
+{
+    const UserTxParams& info = *input.info_;
+    MacNodeId nodeId = MacCidToNodeId(scoreState_[input.slot_].cid_);
+    const std::set<Band>& bands = info.readBands();
+    std::set<Band>::const_iterator it = bands.begin(), et = bands.end();
+    std::set<Remote>::const_iterator antennaIt = info.readAntennaSet().begin(), antennaEt = info.readAntennaSet().end();
+    unsigned int blocks = 0;
+    unsigned int bytes = 0;
+    for (; antennaIt != antennaEt; ++antennaIt)
+    {
+        for (; it != et; ++it)
+        {
+            blocks += eNbScheduler_->readAvailableRbs(nodeId, *antennaIt, *it);
+            bytes += eNbScheduler_->mac_->getAmc()->computeBytesOnNRbs(nodeId, *it, blocks, input.dir_, carrierFrequency_);
+        }
+    }
+
+    input.blocks_ = blocks;
+    input.bytes_ = bytes;
+    input.computed_ = true;
+}
+
+void LteScheduler::refreshDirtyScores()
+{
+    // note that new slots may be marked as dirty while the list is processed
+    for (unsigned int i = 0; i < dirtySlots_.size(); ++i)
+    {
+        unsigned int slot = dirtySlots_[i];
+        ScoreState& state = scoreState_[slot];
+        if (!state.tracked_)
+        {
+            // the connection has been removed after being marked, the slot can be reused now
+            state.dirty_ = false;
+            freeScoreSlots_.push_back(slot);
+            continue;
+        }
+
+        ScoreInput input;
+        if (gatherScoreInput(slot, input))
+        {
+            // the AMC is used only for the inputs that the tables cannot serve
+            computeScoreInput(input);
+            if (!input.computed_)
+                computeScoreInputByAmc(input);
+
+            ScoreState& refreshed = scoreState_[slot];
+            refreshed.availableBlocks_ = input.blocks_;
+            refreshed.availableBytes_ = input.bytes_;
+            refreshed.scorable_ = true;
+        }
+        if (scoreState_[slot].tracked_)
+            updateScore(slot);
+    }
+    dirtySlots_.clear();
+}
+
+bool LteScheduler::isScoreSlotEligible(unsigned int slot)
+{
+    const ScoreState& state = scoreState_[slot];
+    MacNodeId nodeId = MacCidToNodeId(state.cid_);
+    if (nodeId == 0 || binder_->getOmnetId(nodeId) == 0)
+    {
+        // node has left the simulation - erase corresponding CIDs
+        EV << "CID " << state.cid_ << " of node " << nodeId << " removed from active connection set - no OmnetId in Binder known." << endl;
+        eNbScheduler_->removeActiveConnection(state.cid_);
+        return false;
+    }
+
+    // no more free codewords
+    return eNbScheduler_->allocatedCws(nodeId) != state.codewords_;
+}
+
+void LteScheduler::commitInactiveConnections()
+{
+    for (unsigned int i = 0; i < inactiveCids_.size(); ++i)
+        eNbScheduler_->removeActiveConnection(inactiveCids_[i]);
+    inactiveCids_.clear();
+}
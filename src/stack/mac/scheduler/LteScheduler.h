@@ -51,6 +51,147 @@ struct SortedDesc
     }
 };
 
+/**
+ * Indexed max-heap of connection scores.
+ *
+ * Used by score-based schedulers that keep their scores across TTIs: each connection
+ * appears at most once, and its score can be inserted, changed or removed in logarithmic
+ * time, so that only the connections whose score changed need to be touched.
+ * Connections are addressed by a dense slot index assigned by the scheduler, so that no
+ * lookup by connection identifier is needed.
+ * Ties are broken deterministically in favour of the lowest connection identifier.
+ */
+template<typename T, typename S>
+class IndexedScoreHeap
+{
+    typedef SortedDesc<T, S> Entry;
+
+    /// Slots in heap order
+    std::vector<unsigned int> heap_;
+
+    /// Entry of each slot
+    std::vector<Entry> entry_;
+
+    /// Position of each slot within heap_, -1 if the slot is not in the heap
+    std::vector<int> position_;
+
+    bool before(unsigned int i, unsigned int j) const
+    {
+        const Entry& a = entry_[heap_[i]];
+        const Entry& b = entry_[heap_[j]];
+        if (a.score_ != b.score_)
+            return a.score_ > b.score_;
+        return a.x_ < b.x_;
+    }
+
+    void swapEntries(unsigned int i, unsigned int j)
+    {
+        std::swap(heap_[i], heap_[j]);
+        position_[heap_[i]] = i;
+        position_[heap_[j]] = j;
+    }
+
+    void siftUp(unsigned int i)
+    {
+        while (i > 0)
+        {
+            unsigned int parent = (i - 1) / 2;
+            if (!before(i, parent))
+                break;
+            swapEntries(i, parent);
+            i = parent;
+        }
+    }
+
+    void siftDown(unsigned int i)
+    {
+        unsigned int n = heap_.size();
+        while (true)
+        {
+            unsigned int best = i;
+            unsigned int left = 2 * i + 1, right = left + 1;
+            if (left < n && before(left, best))
+                best = left;
+            if (right < n && before(right, best))
+                best = right;
+            if (best == i)
+                break;
+            swapEntries(i, best);
+            i = best;
+        }
+    }
+
+  public:
+
+    bool empty() const { return heap_.empty(); }
+    unsigned int size() const { return heap_.size(); }
+    bool contains(unsigned int slot) const { return slot < position_.size() && position_[slot] >= 0; }
+
+    /// Returns the slot with the highest score
+    unsigned int top() const { return heap_.front(); }
+
+    /// Returns the entry of a slot in the heap
+    const Entry& entry(unsigned int slot) const { return entry_[slot]; }
+
+    /// Inserts the connection in the given slot, or changes its score if already present
+    void update(unsigned int slot, const T x, const S score)
+    {
+        if (slot >= position_.size())
+        {
+            position_.resize(slot + 1, -1);
+            entry_.resize(slot + 1);
+        }
+        if (position_[slot] < 0)
+        {
+            entry_[slot] = Entry(x, score);
+            heap_.push_back(slot);
+            position_[slot] = heap_.size() - 1;
+            siftUp(heap_.size() - 1);
+            return;
+        }
+        if (entry_[slot].score_ == score)
+            return;
+        entry_[slot].score_ = score;
+        siftUp(position_[slot]);
+        siftDown(position_[slot]);
+    }
+
+    /// Removes the slot, if present
+    void erase(unsigned int slot)
+    {
+        if (!contains(slot))
+            return;
+        unsigned int i = position_[slot];
+        unsigned int last = heap_.size() - 1;
+        if (i != last)
+            swapEntries(i, last);
+        position_[slot] = -1;
+        heap_.pop_back();
+        if (i < heap_.size())
+        {
+            siftUp(i);
+            siftDown(position_[heap_[i]]);
+        }
+    }
+
+    /// Removes the entry with the highest score
+    void pop() { erase(heap_.front()); }
+
+    /// Multiplies all the scores by a positive factor (the ordering is preserved)
+    void rescale(const S factor)
+    {
+        for (unsigned int i = 0; i < heap_.size(); ++i)
+            entry_[heap_[i]].score_ *= factor;
+    }
+
+    void clear()
+    {
+        heap_.clear();
+        entry_.clear();
+        position_.clear();
+    }
+};
+
 /**
  * @class LteScheduler
  */
@@ -104,6 +245,93 @@ class LteScheduler
     unsigned int maxSchedulingPeriodCounter_;
     unsigned int currentSchedulingPeriodCounter_;
 
+    /*
+     * Incremental scoring support
+     *
+     * When enabled, score-based schedulers keep their per-connection scores across TTIs.
+     * Connections are tracked from the notification of their activation to the one of their
+     * removal from the active set, and each tracked connection owns a dense slot of the
+     * score state. A score is recomputed only for the slots marked as dirty, i.e. when the
+     * AMC reports new transmission parameters for the node, when the blocks available at the
+     * beginning of the TTI differ from the previous TTI, or when scheduler-specific state
+     * (e.g. the PF long-term rate) changed. Hence, a TTI costs time proportional to the
+     * changed and served connections rather than to the active ones.
+     */
+    bool incrementalScoring_;
+
+    /// true once the connections active before the first TTI have been tracked
+    bool scoreTrackingInitialized_;
+
+    /// Inputs and result of the last rate computation for a tracked connection
+    struct ScoreState
+    {
+        MacCid cid_;
+        /// false if the slot is free
+        bool tracked_;
+        /// true if the score must be recomputed in the next TTI
+        bool dirty_;
+        /// false if the connection cannot be scored, e.g. a codeword has null CQI
+        bool scorable_;
+        unsigned int codewords_;
+        unsigned int availableBlocks_;
+        unsigned int availableBytes_;
+
+        ScoreState()
+        {
+            cid_ = 0;
+            tracked_ = false;
+            dirty_ = false;
+            scorable_ = false;
+            codewords_ = 0;
+            availableBlocks_ = 0;
+            availableBytes_ = 0;
+        }
+    };
+
+    /// Score state of the tracked connections, indexed by slot
+    std::vector<ScoreState> scoreState_;
+
+    /// Slot of each tracked connection. Only accessed on activation, removal and CQI changes
+    std::map<MacCid, unsigned int> scoreSlot_;
+
+    /// Released slots, reused by the next tracked connections
+    std::vector<unsigned int> freeScoreSlots_;
+
+    /// Slots whose score must be recomputed in the next TTI
+    std::vector<unsigned int> dirtySlots_;
+
+    /// Blocks available at the beginning of the last TTI (see LteSchedulerEnb::readAvailableRbsSnapshot())
+    std::vector<unsigned int> availableRbsSnapshot_;
+    std::vector<unsigned int> availableRbsBuffer_;
+
+    /// true if the snapshot does not depend on the node, i.e. only the main plane is configured
+    bool availableRbsUniform_;
+
+    /// Number of bands of each antenna in the snapshot
+    unsigned int numBands_;
+
+    /// Inputs and result of the rate computation of a dirty connection
+    struct ScoreInput
+    {
+        unsigned int slot_;
+        Direction dir_;
+        const UserTxParams* info_;
+        unsigned int codewords_;
+        /// bits carried by each codeword on 1..maxBlocks_ blocks (see LteAmc::readTbsTable())
+        const unsigned int* tbs_[MAX_CODEWORDS];
+        unsigned int maxBlocks_;
+        /// false if the result must be computed through the AMC
+        bool computed_;
+        unsigned int blocks_;
+        unsigned int bytes_;
+    };
+
+    /// Scratch buffer for the nodes whose transmission parameters changed
+    std::vector<MacNodeId> changedNodes_;
+
+    /// Connections found inactive during the scheduling of this TTI, removed from the active set on commit
+    std::vector<MacCid> inactiveCids_;
+
   public:
 
     /**
@@ -114,6 +342,10 @@ class LteScheduler
         //    WATCH(activeSet_);
         activeConnectionSet_ = nullptr;
         binder_ = nullptr;
+        incrementalScoring_ = false;
+        scoreTrackingInitialized_ = false;
+        availableRbsUniform_ = false;
+        numBands_ = 0;
     }
     /**
      * Destructor.
@@ -196,9 +428,12 @@ class LteScheduler
     /// calls LteSchedulerEnbUl::racschedule()
     virtual bool scheduleRacRequests();
 
-    virtual void notifyActiveConnection(MacCid activeCid)
-    {
-    }
+    /// with incremental scoring, starts tracking the connection
+    virtual void notifyActiveConnection(MacCid activeCid);
+
+    /// called when the connection has been removed from the active set
+    virtual void notifyInactiveConnection(MacCid cid);
+
     virtual void updateSchedulingInfo()
     {
     }
@@ -211,6 +446,93 @@ class LteScheduler
      */
     void buildCarrierActiveConnectionSet();
 
+    /*
+     * Returns the direction of a connection scheduled by this scheduler
+     */
+    Direction getConnectionDirection(MacCid cid) const;
+
+    /*
+     * Tracks the connections currently active, the first time incremental scoring is used
+     */
+    void initializeScoreTracking();
+
+    /*
+     * Assigns a slot to the connection, if its node may use this carrier, and marks it as dirty
+     */
+    void trackConnection(MacCid cid);
+
+    /*
+     * Releases the slot of the connection, if any
+     */
+    void untrackConnection(MacCid cid);
+
+    /*
+     * Hooks for the schedulers, called after a slot has been assigned and before it is released
+     */
+    virtual void connectionTracked(unsigned int slot)
+    {
+    }
+    virtual void connectionUntracked(unsigned int slot)
+    {
+    }
+
+    /*
+     * Marks the slot as dirty, so that its score is recomputed in the next TTI
+     */
+    void markScoreDirty(unsigned int slot);
+
+    /*
+     * Marks as dirty the slots whose inputs changed since the last TTI, i.e. those of the nodes
+     * with new transmission parameters, or all of them if the available blocks changed
+     */
+    void collectScoreChanges();
+
+    /*
+     * Reads the transmission parameters and the AMC tables of the connection in the given slot,
+     * and clears its dirty flag. A connection whose node left the simulation is removed from
+     * the active set
+     *
+     * @return false if the connection cannot be scored
+     */
+    bool gatherScoreInput(unsigned int slot, ScoreInput& input);
+
+    /*
+     * Computes the blocks and bytes available to the connection, in the same way as the
+     * score-based schedulers do, from the gathered input and the snapshot of the available blocks.
+     * It leaves the input not computed if the AMC is needed
+     */
+    void computeScoreInput(ScoreInput& input) const;
+
+    /*
+     * Computes the blocks and bytes available to the connection through the AMC
+     */
+    void computeScoreInputByAmc(ScoreInput& input);
+
+    /*
+     * Refreshes the state of the dirty slots and calls updateScore() for each of them
+     */
+    void refreshDirtyScores();
+
+    /*
+     * Hook for the schedulers, called after the state of the slot has been refreshed.
+     * The score must be discarded if the state is not scorable
+     */
+    virtual void updateScore(unsigned int slot)
+    {
+    }
+
+    /*
+     * Returns true if the connection in the given slot can be served in this TTI, i.e.
+     * it still exists and its node has free codewords. A connection whose node left the
+     * simulation is removed from the active set
+     */
+    bool isScoreSlotEligible(unsigned int slot);
+
+    /*
+     * Removes from the active set the connections found inactive in this TTI
+     */
+    void commitInactiveConnections();
+
 };
 
 #endif // _LTE_LTESCHEDULER_H_
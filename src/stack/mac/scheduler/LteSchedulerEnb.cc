@@ -157,6 +157,11 @@ std::map<double, LteMacScheduleList>* LteSchedulerEnb::schedule()
     resetAllocator();
 
     // schedule one carrier at a time
+    // NOTE: carriers are scheduled sequentially on purpose. All of them share the same allocator,
+    // schedule lists and allocated codewords, so the scheduling of one carrier depends on the ones
+    // scheduled before it. Moreover, scheduling draws from the simulation RNGs (e.g. score ties),
+    // emits signals and logs through EV, none of which may be used concurrently in OMNeT++,
+    // and the order of RNG draws must be preserved for results to be reproducible
     LteScheduler* scheduler = NULL;
     std::vector<LteScheduler*>::iterator it = scheduler_.begin();
     for ( ; it != scheduler_.end(); ++it)
@@ -911,6 +916,11 @@ unsigned int LteSchedulerEnb::readAvailableRbs(const MacNodeId id,
     return allocator_->availableBlocks(id, antenna, b);
 }
 
+bool LteSchedulerEnb::readAvailableRbsSnapshot(std::vector<unsigned int>& available)
+{
+    return allocator_->readAvailableBlocks(available);
+}
+
 unsigned int LteSchedulerEnb::readTotalAvailableRbs()
 {
     return allocator_->computeTotalRbs();
@@ -1096,6 +1106,16 @@ ActiveSet* LteSchedulerEnb::readActiveConnections()
     return &activeConnectionSet_;
 }
 
+void LteSchedulerEnb::removeActiveConnection(MacCid cid)
+{
+    if (activeConnectionSet_.erase(cid) == 0)
+        return;
+
+    std::vector<LteScheduler*>::iterator it = scheduler_.begin();
+    for ( ; it != scheduler_.end(); ++it)
+        (*it)->notifyInactiveConnection(cid);
+}
+
 void LteSchedulerEnb::removeActiveConnections(MacNodeId nodeId)
 {
     ActiveSet::iterator it = activeConnectionSet_.begin();
@@ -1108,6 +1128,10 @@ void LteSchedulerEnb::removeActiveConnections(MacNodeId nodeId)
         {
             EV << NOW << "LteSchedulerEnb::removeActiveConnections CID removed " << cid << endl;
             activeConnectionSet_.erase(it++);
+
+            std::vector<LteScheduler*>::iterator sit = scheduler_.begin();
+            for ( ; sit != scheduler_.end(); ++sit)
+                (*sit)->notifyInactiveConnection(cid);
         }
         else
             ++it;
@@ -209,6 +209,12 @@ class LteSchedulerEnb
      */
     unsigned int readAvailableRbs(const MacNodeId id, const Remote antenna, const Band b);
 
+    /*
+     * Reads the amount of free blocks for each plane, antenna and band of the allocator.
+     * Returns false if the amount of free blocks also depends on the node (see LteAllocationModule)
+     */
+    bool readAvailableRbsSnapshot(std::vector<unsigned int>& available);
+
     /**
      * Returns the number of available blocks.
      */
@@ -264,6 +270,11 @@ class LteSchedulerEnb
      */
     ActiveSet* readActiveConnections();
 
+    /*
+     * Removes the connection from the active set and notifies the schedulers
+     */
+    void removeActiveConnection(MacCid cid);
+
     void removeActiveConnections(MacNodeId nodeId);
 
   protected:
@@ -12,6 +12,7 @@
 #include "stack/mac/scheduling_modules/LteMaxCi.h"
 #include "stack/mac/scheduler/LteSchedulerEnb.h"
 #include "stack/backgroundTrafficGenerator/BackgroundTrafficManager.h"
+#include <algorithm>
 
 using namespace omnetpp;
 
@@ -19,6 +20,12 @@ void LteMaxCi::prepareSchedule()
 {
     EV << NOW << " LteMaxCI::schedule " << eNbScheduler_->mac_->getMacNodeId() << endl;
 
+    if (incrementalScoring_)
+    {
+        prepareScheduleIncremental();
+        return;
+    }
+
     if (binder_ == nullptr)
         binder_ = getBinder();
 
@@ -185,6 +192,128 @@ void LteMaxCi::prepareSchedule()
 
 void LteMaxCi::commitSchedule()
 {
-    *activeConnectionSet_ = activeConnectionTempSet_;
+    if (incrementalScoring_)
+        commitInactiveConnections();
+    else
+        *activeConnectionSet_ = activeConnectionTempSet_;
+}
+
+// orders the scores as the persistent score list does, i.e. ties are broken by connection id
+static bool scoreBefore(const SortedDesc<MacCid, unsigned int>& a, const SortedDesc<MacCid, unsigned int>& b)
+{
+    if (a.score_ != b.score_)
+        return a.score_ > b.score_;
+    return a.x_ < b.x_;
+}
+
+void LteMaxCi::prepareScheduleIncremental()
+{
+    // Refresh the score of the connections whose rate changed since the last TTI
+    collectScoreChanges();
+    refreshDirtyScores();
+
+    // background UEs are scored at every TTI, as in the default mode
+    bgScores_.clear();
+    if (direction_ == UL || direction_ == DL)
+    {
+        BackgroundTrafficManager* bgTrafficManager = eNbScheduler_->mac_->getBackgroundTrafficManager(carrierFrequency_);
+        std::list<int>::const_iterator it = bgTrafficManager->getBackloggedUesBegin(direction_),
+                                         et = bgTrafficManager->getBackloggedUesEnd(direction_);
+        for (; it != et; ++it)
+        {
+            MacNodeId bgUeId = BGUE_MIN_ID + *it;
+            MacCid bgCid = bgUeId << 16;
+            bgScores_.push_back(ScoreDesc(bgCid, bgTrafficManager->getBackloggedUeBytesPerBlock(bgUeId, direction_)));
+        }
+        std::sort(bgScores_.begin(), bgScores_.end(), scoreBefore);
+    }
+    unsigned int nextBg = 0;
+
+    // Schedule the connections in score order, merging the persistent score list with the one
+    // of the background UEs. Connections that are still active but cannot be served anymore
+    // in this TTI are put back into the score list afterwards
+    deferredSlots_.clear();
+    while ( ! scoreHeap_.empty () || nextBg < bgScores_.size() )
+    {
+        unsigned int slot = 0;
+        ScoreDesc current;
+        bool background = (scoreHeap_.empty() || (nextBg < bgScores_.size() && scoreBefore(bgScores_[nextBg], scoreHeap_.entry(scoreHeap_.top()))));
+        if (background)
+            current = bgScores_[nextBg];
+        else
+        {
+            slot = scoreHeap_.top();
+            current = scoreHeap_.entry(slot);
+
+            if (!isScoreSlotEligible(slot))
+            {
+                // the slot has already been dropped from the score list if its connection was removed
+                if (scoreHeap_.contains(slot))
+                {
+                    scoreHeap_.erase(slot);
+                    deferredSlots_.push_back(slot);
+                }
+                continue;
+            }
+        }
+
+        bool terminate = false;
+        bool active = true;
+        bool eligible = true;
+        unsigned int granted;
+
+        if (background)
+            granted = requestGrantBackground (current.x_, 4294967295U, terminate, active, eligible);
+        else
+            granted = requestGrant (current.x_, 4294967295U, terminate, active, eligible);
+
+        EV << NOW << "LteMaxCI::schedule granted " << granted << " bytes to connection " << current.x_ << endl;
+
+        if ( terminate ) break;
+
+        if ( ! active || ! eligible )
+        {
+            if (background)
+                nextBg++;
+            else
+            {
+                scoreHeap_.pop ();
+                if ( active )
+                    deferredSlots_.push_back(slot);
+            }
+        }
+
+        if ( ! active && ! background )
+        {
+            EV << NOW << "LteMaxCI::schedule scheduling connection " << current.x_ << " set to inactive " << endl;
+            inactiveCids_.push_back(current.x_);
+        }
+    }
+
+    for (unsigned int i = 0; i < deferredSlots_.size(); ++i)
+    {
+        unsigned int slot = deferredSlots_[i];
+        scoreHeap_.update(slot, scoreHeap_.entry(slot).x_, scoreHeap_.entry(slot).score_);
+    }
+}
+
+void LteMaxCi::connectionUntracked(unsigned int slot)
+{
+    scoreHeap_.erase(slot);
 }
 
+void LteMaxCi::updateScore(unsigned int slot)
+{
+    const ScoreState& state = scoreState_[slot];
+    if (!state.scorable_)
+    {
+        scoreHeap_.erase(slot);
+        return;
+    }
+
+    // current user bytes per slot
+    unsigned int byPs = (state.availableBlocks_ > 0) ? (state.availableBytes_ / state.availableBlocks_) : 0;
+    scoreHeap_.update(slot, state.cid_, byPs);
+
+    EV << NOW << " LteMaxCI::schedule computed for cid " << state.cid_ << " score of " << byPs << endl;
+}
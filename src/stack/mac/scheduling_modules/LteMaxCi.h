@@ -21,6 +21,22 @@ class LteMaxCi : public virtual LteScheduler
     typedef SortedDesc<MacCid, unsigned int> ScoreDesc;
     typedef std::priority_queue<ScoreDesc> ScoreList;
 
+    //! Persistent score list, used with incremental scoring
+    IndexedScoreHeap<MacCid, unsigned int> scoreHeap_;
+
+    //! Slots that cannot be served anymore in the current TTI, put back into the score list afterwards
+    std::vector<unsigned int> deferredSlots_;
+
+    //! Scores of the backlogged background UEs, rebuilt at every TTI with incremental scoring
+    std::vector<ScoreDesc> bgScores_;
+
+    // incremental version of prepareSchedule()
+    void prepareScheduleIncremental();
+
+    // incremental scoring hooks
+    virtual void connectionUntracked(unsigned int slot);
+    virtual void updateScore(unsigned int slot);
+
   public:
 
     virtual void prepareSchedule();
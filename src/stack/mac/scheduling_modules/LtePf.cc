@@ -14,8 +14,23 @@
 
 using namespace omnetpp;
 
+void LtePf::setEnbScheduler(LteSchedulerEnb* eNbScheduler)
+{
+    LteScheduler::setEnbScheduler(eNbScheduler);
+
+    // scaled long-term rates need a non-null decay factor
+    if (pfAlpha_ >= 1.0)
+        incrementalScoring_ = false;
+}
+
 void LtePf::prepareSchedule()
 {
+    if (incrementalScoring_)
+    {
+        prepareScheduleIncremental();
+        return;
+    }
+
     EV << NOW << "LtePf::execSchedule ############### eNodeB " << eNbScheduler_->mac_->getMacNodeId() << " ###############" << endl;
     EV << NOW << "LtePf::execSchedule Direction: " << ( ( direction_ == DL ) ? " DL ": " UL ") << endl;
 
@@ -163,6 +178,12 @@ void LtePf::prepareSchedule()
 
 void LtePf::commitSchedule()
 {
+    if (incrementalScoring_)
+    {
+        commitScheduleIncremental();
+        return;
+    }
+
     unsigned int total = eNbScheduler_->resourceBlocks_;
 
     std::map<MacCid, unsigned int>::iterator it = grantedBytes_.begin();
@@ -196,3 +217,158 @@ void LtePf::commitSchedule()
     *activeConnectionSet_ = activeConnectionTempSet_;
 }
 
+void LtePf::prepareScheduleIncremental()
+{
+    EV << NOW << "LtePf::execSchedule (incremental) ############### eNodeB " << eNbScheduler_->mac_->getMacNodeId() << " ###############" << endl;
+
+    // Refresh the score of the connections whose rate or long-term rate changed since the last TTI
+    collectScoreChanges();
+    refreshDirtyScores();
+
+    // Schedule the connections in score order. Connections that are still active but
+    // cannot be served anymore in this TTI are put back into the score list afterwards
+    deferredSlots_.clear();
+    while(!scoreHeap_.empty())
+    {
+        unsigned int slot = scoreHeap_.top();
+        MacCid cid = scoreHeap_.entry(slot).x_;
+
+        if (!isScoreSlotEligible(slot))
+        {
+            // the slot has already been dropped from the score list if its connection was removed
+            if (scoreHeap_.contains(slot))
+            {
+                scoreHeap_.erase(slot);
+                deferredSlots_.push_back(slot);
+            }
+            continue;
+        }
+
+        EV << NOW << "LtePf::execSchedule CID: " << cid << " Score: " << scoreHeap_.entry(slot).score_ << endl;
+
+        bool terminate = false;
+        bool active = true;
+        bool eligible = true;
+
+        unsigned int granted = requestGrant (cid, 4294967295U, terminate, active, eligible);
+        if (granted > 0)
+        {
+            if (slotGrantedBytes_[slot] == 0)
+                grantedSlots_.push_back(slot);
+            slotGrantedBytes_[slot] += granted;
+        }
+
+        EV << NOW << "LtePf::execSchedule Granted: " << granted << " bytes" << endl;
+
+        if(terminate)
+        {
+            EV << NOW << "LtePf::execSchedule TERMINATE " << endl;
+            break;
+        }
+
+        if(!active || !eligible)
+        {
+            scoreHeap_.pop();
+            if (active)
+                deferredSlots_.push_back(slot);
+        }
+
+        if(!active)
+        {
+            EV << NOW << "LtePf::execSchedule NOT ACTIVE" << endl;
+            inactiveCids_.push_back(cid);
+        }
+    }
+
+    for (unsigned int i = 0; i < deferredSlots_.size(); ++i)
+    {
+        unsigned int slot = deferredSlots_[i];
+        scoreHeap_.update(slot, scoreHeap_.entry(slot).x_, scoreHeap_.entry(slot).score_);
+    }
+}
+
+void LtePf::commitScheduleIncremental()
+{
+    unsigned int total = eNbScheduler_->resourceBlocks_;
+
+    // the long-term rates of all the tracked connections decay, which only affects the common scale factor
+    pfScale_ *= (1.0 - pfAlpha_);
+
+    // only the connections that have been served need their long-term rate (and score) updated
+    for (unsigned int i = 0; i < grantedSlots_.size(); ++i)
+    {
+        unsigned int slot = grantedSlots_[i];
+        double shortTermRate = (total > 0) ? double(slotGrantedBytes_[slot]) / double(total) : 0.0;
+        pfScaledRate_[slot] += pfAlpha_ * shortTermRate / pfScale_;
+        slotGrantedBytes_[slot] = 0;
+        markScoreDirty(slot);
+
+        EV << NOW << " LtePf::storeSchedule CID " << scoreState_[slot].cid_ << " Long Term Rate = " << pfScaledRate_[slot] * pfScale_ << endl;
+    }
+    grantedSlots_.clear();
+
+    // renormalize before the scale factor underflows
+    if (pfScale_ < 1e-100)
+    {
+        for (unsigned int slot = 0; slot < scoreState_.size(); ++slot)
+        {
+            if (scoreState_[slot].tracked_)
+                pfScaledRate_[slot] *= pfScale_;
+        }
+        scoreHeap_.rescale(1.0 / pfScale_);
+        pfScale_ = 1.0;
+    }
+
+    // the rates of the connections removed here are stored back unscaled, after this TTI's decay
+    commitInactiveConnections();
+
+    // the long-term rates decay without the connections being rescored, so the connections whose
+    // rate is now below scoreEpsilon_ get their (capped) score updated. Their inputs are unchanged
+    for (unsigned int slot = 0; slot < scoreState_.size(); ++slot)
+    {
+        const ScoreState& state = scoreState_[slot];
+        if (state.tracked_ && !state.dirty_ && pfScaledRate_[slot] * pfScale_ < scoreEpsilon_)
+            updateScore(slot);
+    }
+}
+
+void LtePf::connectionTracked(unsigned int slot)
+{
+    if (slot >= pfScaledRate_.size())
+    {
+        pfScaledRate_.resize(slot + 1, 0.0);
+        slotGrantedBytes_.resize(slot + 1, 0);
+    }
+
+    PfRate::iterator it = pfRate_.find(scoreState_[slot].cid_);
+    pfScaledRate_[slot] = (it != pfRate_.end()) ? it->second / pfScale_ : 0.0;
+    slotGrantedBytes_[slot] = 0;
+}
+
+void LtePf::connectionUntracked(unsigned int slot)
+{
+    pfRate_[scoreState_[slot].cid_] = pfScaledRate_[slot] * pfScale_;
+    scoreHeap_.erase(slot);
+}
+
+void LtePf::updateScore(unsigned int slot)
+{
+    const ScoreState& state = scoreState_[slot];
+    if (!state.scorable_)
+    {
+        scoreHeap_.erase(slot);
+        return;
+    }
+
+    // the score is the ratio between bytes per block and the (scaled) long-term rate, hence
+    // scores are scaled by pfScale_ as well. As in the default mode, the score of a connection
+    // whose long-term rate is below scoreEpsilon_ is 1/scoreEpsilon_
+    double rate = pfScaledRate_[slot];
+    double s;
+    if (rate * pfScale_ < scoreEpsilon_) s = pfScale_ / scoreEpsilon_;
+    else if (state.availableBlocks_ > 0) s = (state.availableBytes_ / state.availableBlocks_) / rate;
+    else s = 0.0;
+    scoreHeap_.update(slot, state.cid_, s);
+
+    EV << NOW << "LtePf::execSchedule CID " << state.cid_ << "- Score = " << s << endl;
+}
@@ -34,6 +34,40 @@ class LtePf : public LteScheduler
     //! Small number to slightly blur away scores.
     const double scoreEpsilon_;
 
+    /*
+     * Incremental scoring
+     *
+     * While a connection is tracked, i.e. active on this carrier, its long-term rate is stored
+     * in pfScaledRate_ divided by pfScale_, the common decay factor applied to all the tracked
+     * connections since the last renormalization. In this way, the rate of a connection that
+     * was not served does not need to be updated, and the relative order of the scores is
+     * preserved. When the connection is no longer tracked, its actual rate is stored back in
+     * pfRate_, so that it does not decay while the connection is idle, as in the default mode.
+     */
+    double pfScale_;
+
+    //! Scaled long-term rates of the tracked connections, indexed by slot
+    std::vector<double> pfScaledRate_;
+
+    //! Bytes granted to each slot in the current TTI, and slots with a non-zero grant
+    std::vector<unsigned int> slotGrantedBytes_;
+    std::vector<unsigned int> grantedSlots_;
+
+    //! Slots that cannot be served anymore in the current TTI, put back into the score list afterwards
+    std::vector<unsigned int> deferredSlots_;
+
+    //! Persistent score list, used with incremental scoring
+    IndexedScoreHeap<MacCid, double> scoreHeap_;
+
+    // incremental versions of the scheduling functions
+    void prepareScheduleIncremental();
+    void commitScheduleIncremental();
+
+    // incremental scoring hooks
+    virtual void connectionTracked(unsigned int slot);
+    virtual void connectionUntracked(unsigned int slot);
+    virtual void updateScore(unsigned int slot);
+
   public:
 
     double & pfAlpha()
@@ -41,6 +75,9 @@ class LtePf : public LteScheduler
         return pfAlpha_;
     }
 
+    // incremental scoring requires pfAlpha < 1
+    virtual void setEnbScheduler(LteSchedulerEnb* eNbScheduler);
+
     // Scheduling functions ********************************************************************
 
     //virtual void schedule ();
@@ -56,6 +93,7 @@ class LtePf : public LteScheduler
     {
         pfAlpha_ = pfAlpha;
         pfRate_.clear();
+        pfScale_ = 1.0;
     }
 };
 
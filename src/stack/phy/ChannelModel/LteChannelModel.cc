@@ -42,6 +42,44 @@ std::vector<double> LteChannelModel::getSINR(LteAirFrame *frame, UserControlInfo
    return tmp;
 }
 
+std::vector<std::vector<double> > LteChannelModel::getSINRBatch(MacCellId cellId, const std::vector<MacNodeId>& ueIds, double carrierFrequency,
+        const std::vector<UserControlInfo*>& reports)
+{
+   if (reports.size() != ueIds.size())
+       throw cRuntimeError("LteChannelModel::getSINRBatch - %d reports for %d UEs", (int)reports.size(), (int)ueIds.size());
+
+   // the air frame is not used to evaluate the feedback
+   std::vector<std::vector<double> > sinr(ueIds.size());
+   for (unsigned int k = 0; k < ueIds.size(); k++)
+   {
+       // wideband feedback only uses the SINR averaged over the bands
+       if (reports[k]->feedbackReq.type == WIDEBAND)
+           sinr[k].assign(1, getMeanSINR(nullptr, reports[k]));
+       else
+           sinr[k] = getSINR(nullptr, reports[k]);
+   }
+   return sinr;
+}
+
+double LteChannelModel::getMeanSINR(LteAirFrame *frame, UserControlInfo* lteInfo)
+{
+   std::vector<double> snrV = getSINR(frame, lteInfo);
+   double snr = 0;
+   for (unsigned int i = 0; i < snrV.size(); i++)
+       snr += snrV[i];
+   return snr / snrV.size();
+}
+
+double LteChannelModel::getWidebandSNR(LteAirFrame *frame, UserControlInfo* lteInfo)
+{
+   // average the SINR over all the bands
+   std::vector<double> snrV = getSINR(frame, lteInfo);
+   double snr = 0;
+   for (unsigned int i = 0; i < snrV.size(); i++)
+       snr += snrV[i];
+   return snr / snrV.size();
+}
+
 std::vector<double> LteChannelModel::getRSRP(LteAirFrame *frame, UserControlInfo* lteInfo)
 {
    std::vector<double> tmp;
@@ -86,8 +86,9 @@ class LteChannelModel : public omnetpp::cSimpleModule
      * @param nodeid mac node id of UE
      * @param dir traffic direction
      * @param move position of end point comunication (if dir==UL is the position of UE else is the position of eNodeB)
+     * @param meanAttenuation if true, the per-link shadowing is replaced by its mean effect
      */
-    virtual double getAttenuation(MacNodeId nodeId, Direction dir, inet::Coord coord, bool cqiDl) = 0;
+    virtual double getAttenuation(MacNodeId nodeId, Direction dir, inet::Coord coord, bool cqiDl, bool meanAttenuation = false) = 0;
     /*
      * Compute the path-loss attenuation according to the selected scenario
      *
@@ -109,6 +110,33 @@ class LteChannelModel : public omnetpp::cSimpleModule
      * @param lteinfo pointer to the user control info
      */
     virtual std::vector<double> getSINR(LteAirFrame *frame, UserControlInfo* lteInfo) = 0;
+    /*
+     * Compute the DL sinr of a set of UEs served by the given cell, for the feedback they reported.
+     * For each UE, the result is the one of getSINR(), or the single value of getMeanSINR() for
+     * wideband reports. Results are returned in the same order as ueIds
+     *
+     * @param cellId id of the serving cell
+     * @param ueIds ids of the UEs
+     * @param carrierFrequency carrier frequency
+     * @param reports control info of the feedback of each UE (position, tx power and mode, feedback type)
+     */
+    virtual std::vector<std::vector<double> > getSINRBatch(MacCellId cellId, const std::vector<MacNodeId>& ueIds, double carrierFrequency,
+            const std::vector<UserControlInfo*>& reports);
+    /*
+     * Compute the sinr averaged over all the bands, i.e. the value used by wideband feedback
+     *
+     * @param frame pointer to the packet
+     * @param lteinfo pointer to the user control info
+     */
+    virtual double getMeanSINR(LteAirFrame *frame, UserControlInfo* lteInfo);
+    /*
+     * Compute a single wideband SNR value for the given DL frame, according to pathloss and shadowing (optional).
+     * Fading and interference are not considered
+     *
+     * @param frame pointer to the packet
+     * @param lteinfo pointer to the user control info
+     */
+    virtual double getWidebandSNR(LteAirFrame *frame, UserControlInfo* lteInfo);
     /*
      * Compute sinr for each band for a background UE according to pathloss
      *
@@ -40,7 +40,7 @@ class LteDummyChannelModel : public LteChannelModel
    /*
     * Compute Attenuation caused by pathloss and shadowing (optional)
     */
-   virtual double getAttenuation(MacNodeId nodeId, Direction dir, inet::Coord coord, bool cqiDl)
+   virtual double getAttenuation(MacNodeId nodeId, Direction dir, inet::Coord coord, bool cqiDl, bool meanAttenuation = false)
    {
        return 0;
    }
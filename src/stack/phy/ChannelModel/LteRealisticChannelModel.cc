@@ -93,21 +93,66 @@ void LteRealisticChannelModel::initialize(int stage)
 
         collectSinrStatistics_ = par("collectSinrStatistics");
 
+        enableLinkBudgetCache_ = par("enableLinkBudgetCache");
+        memoizeFading_ = par("memoizeFading");
+        aggregateUplinkInterference_ = par("aggregateUplinkInterference");
+        downlinkInterferenceCutoffDistance_ = par("downlinkInterferenceCutoffDistance");
+        downlinkInterferenceThreshold_ = par("downlinkInterferenceThreshold");
+        linkBudgetCache_.clear();
+
+        useShadowingMap_ = par("useShadowingMap");
+        shadowingMapResolution_ = par("shadowingMapResolution");
+        shadowingMapRange_ = par("shadowingMapRange");
+        // the RNG is obtained here, so that a missing RNG mapping is reported at startup
+        shadowingMapRng_ = (useShadowingMap_) ? getRNG(par("shadowingMapRng").intValue()) : nullptr;
+
+        meanInterferencePower_ = par("meanInterferencePower");
+        interferenceShadowingCorrection_ = par("interferenceShadowingCorrection");
+
+        enableExtCellInterferenceCache_ = par("extCellInterferenceCache");
+        extCellCacheGridSize_ = par("extCellCacheGridSize");
+        extCellCache_.clear();
+
+        usePathLossMap_ = par("usePathLossMap");
+        pathLossMapFile_ = par("pathLossMapFile").stdstringValue();
+        pathLossMapOutputFile_ = par("pathLossMapOutputFile").stdstringValue();
+        pathLossMapResolution_ = par("pathLossMapResolution");
+        pathLossMapRange_ = par("pathLossMapRange");
+        pathLossMapInitialized_ = false;
+
         //get binder
         binder_ = getBinder();
         //clear jakes fading map structure
         jakesFadingMap_.clear();
+        nodeState_.clear();
+        nodeSlot_.clear();
+        lastStateNodeId_ = 0;
+        lastState_ = nullptr;
 
         useRsrqFromLog_ = par("useRsrqFromLog").boolValue();
         rsrqShift_ = par("rsrqShift");
         rsrqScale_ = par("rsrqScale");
         oldTime_ = -1;
         oldRsrq_ = 0;
+
+        linkBudgetCacheHits_ = 0;
+        linkBudgetCacheMisses_ = 0;
+        WATCH(linkBudgetCacheHits_);
+        WATCH(linkBudgetCacheMisses_);
+    }
+}
+
+void LteRealisticChannelModel::finish()
+{
+    if (enableLinkBudgetCache_)
+    {
+        recordScalar("linkBudgetCacheHits", linkBudgetCacheHits_);
+        recordScalar("linkBudgetCacheMisses", linkBudgetCacheMisses_);
     }
 }
 
 double LteRealisticChannelModel::getAttenuation(MacNodeId nodeId, Direction dir,
-       Coord coord, bool cqiDl)
+       Coord coord, bool cqiDl, bool meanAttenuation)
 {
    double speed = .0;
    double correlationDist = .0;
@@ -115,6 +160,21 @@ double LteRealisticChannelModel::getAttenuation(MacNodeId nodeId, Direction dir,
    //COMPUTE DISTANCE between ue and eNodeB
    double sqrDistance = phy_->getCoord().distance(coord);
 
+   // if the attenuation for this link has already been computed during this TTI, reuse it
+   if (enableLinkBudgetCache_)
+   {
+       LinkBudget* linkBudget = getCachedLinkBudget(nodeId, cqiDl, coord, meanAttenuation);
+       if (linkBudget != nullptr)
+       {
+           linkBudgetCacheHits_++;
+           if (dir == DL)
+               emit(distance_,sqrDistance);
+
+           EV << "LteRealisticChannelModel::getAttenuation - cached attenuation at distance " << sqrDistance << " for eNb is " << linkBudget->attenuation << endl;
+           return linkBudget->attenuation;
+       }
+   }
+
    if (dir == DL){ // sender is UE
        speed = computeSpeed(nodeId, phy_->getCoord());
        correlationDist = computeCorrelationDistance(nodeId, phy_->getCoord());
@@ -127,23 +187,31 @@ double LteRealisticChannelModel::getAttenuation(MacNodeId nodeId, Direction dir,
    // correlation distance UE could have changed its state and
    // its visibility from eNodeb, hence it is correct to recompute the los probability
    if (correlationDist > correlationDistance_
-           || losMap_.find(nodeId) == losMap_.end())
+           || !getNodeState(nodeId).hasLos)
    {
        computeLosProbability(sqrDistance, nodeId);
+       invalidateLinkBudget(nodeId);
    }
 
    if(dir == DL)
        emit(distance_,sqrDistance);
 
    //compute attenuation based on selected scenario and based on LOS or NLOS
-   bool los = losMap_[nodeId];
+   bool los = getLos(nodeId);
    double dbp = 0;
-   double attenuation = computePathLoss(sqrDistance, dbp, los);
+   double attenuation = getPathLoss(coord, sqrDistance, dbp, los);
 
    //    Applying shadowing only if it is enabled by configuration
    //    log-normal shadowing (not available for background UEs)
    if (nodeId < BGUE_MIN_ID && shadowing_)
-       attenuation += computeShadowing(sqrDistance, nodeId, speed, cqiDl);
+   {
+       if (meanAttenuation)
+           attenuation += computeMeanShadowing(nodeId);
+       else if (useShadowingMap_)
+           attenuation += computeShadowingFromMap(coord, nodeId, cqiDl);
+       else
+           attenuation += computeShadowing(sqrDistance, nodeId, speed, cqiDl);
+   }
 
    // update current user position
 
@@ -158,12 +226,18 @@ double LteRealisticChannelModel::getAttenuation(MacNodeId nodeId, Direction dir,
        updateCorrelationDistance(nodeId, coord);
    }
 
+   if (enableLinkBudgetCache_)
+   {
+       linkBudgetCacheMisses_++;
+       storeLinkBudget(nodeId, cqiDl, coord, meanAttenuation, attenuation);
+   }
+
    EV << "LteRealisticChannelModel::getAttenuation - computed attenuation at distance " << sqrDistance << " for eNb is " << attenuation << endl;
 
    return attenuation;
 }
 
-double LteRealisticChannelModel::getAttenuation_D2D(MacNodeId nodeId, Direction dir, Coord coord,MacNodeId node2_Id, Coord coord_2, bool cqiDl)
+double LteRealisticChannelModel::getAttenuation_D2D(MacNodeId nodeId, Direction dir, Coord coord,MacNodeId node2_Id, Coord coord_2, bool cqiDl, bool meanAttenuation)
 {
    double speed = .0;
    double correlationDist = .0;
@@ -178,20 +252,21 @@ double LteRealisticChannelModel::getAttenuation_D2D(MacNodeId nodeId, Direction
    // correlation distance UE could have changed its state and
    // its visibility from eNodeb, hence it is correct to recompute the LOS probability
    if (correlationDist > correlationDistance_
-       || losMap_.find(nodeId) == losMap_.end())
+       || !getNodeState(nodeId).hasLos)
    {
        computeLosProbability(sqrDistance, nodeId);
+       invalidateLinkBudget(nodeId);
    }
 
    //compute attenuation based on selected scenario and based on LOS or NLOS
-   bool los = losMap_[nodeId];
+   bool los = getLos(nodeId);
    double dbp = 0;
    double attenuation = computePathLoss(sqrDistance, dbp, los);
 
    //    Applying shadowing only if it is enabled by configuration
    //    log-normal shadowing (not available for background UEs)
    if (nodeId < BGUE_MIN_ID && shadowing_)
-       attenuation += computeShadowing(sqrDistance, nodeId, speed, cqiDl);
+       attenuation += (meanAttenuation) ? computeMeanShadowing(nodeId) : computeShadowing(sqrDistance, nodeId, speed, cqiDl);
 
    // update current user position
    updatePositionHistory(nodeId, coord);
@@ -201,17 +276,73 @@ double LteRealisticChannelModel::getAttenuation_D2D(MacNodeId nodeId, Direction
    return attenuation;
 }
 
+double LteRealisticChannelModel::getInterferenceAttenuation(MacNodeId nodeId, Coord coord, bool cqiDl)
+{
+   return getAttenuation(nodeId, UL, coord, cqiDl, meanInterferencePower_);
+}
+
+double LteRealisticChannelModel::getInterferenceAttenuation_D2D(MacNodeId nodeId, Coord coord, MacNodeId node2_Id, Coord coord_2)
+{
+   return getAttenuation_D2D(nodeId, D2D, coord, node2_Id, coord_2, false, meanInterferencePower_);
+}
+
+double LteRealisticChannelModel::computeMeanShadowing(MacNodeId nodeId)
+{
+   if (!interferenceShadowingCorrection_)
+       return 0.0;
+
+   // for a log-normal shadowing S ~ N(0, stdDev^2) dB, E[10^(-S/10)] = exp((stdDev * ln10 / 10)^2 / 2),
+   // i.e. the mean received power is stdDev^2 * ln10 / 20 dB above the one given by the path loss
+   double stdDev = getShadowingStdDev(nodeId);
+   return -stdDev * stdDev * log(10.0) / 20.0;
+}
+
+double LteRealisticChannelModel::getShadowingStdDev(MacNodeId nodeId)
+{
+   return getStdDev(false, nodeId);
+}
+
+double LteRealisticChannelModel::computeShadowingFromMap(const Coord& coord, MacNodeId nodeId, bool cqiDl)
+{
+   // the field belongs to the base station, which is either the owner of this channel model or the other end point
+   bool isBs = phy_->getMacNodeId() <= ENB_MAX_ID;
+   const Coord& bsCoord = (isBs) ? phy_->getCoord() : coord;
+   const Coord& ueCoord = (isBs) ? coord : phy_->getCoord();
+
+   // base stations are static, hence they are identified by their position
+   ShadowingMap& map = binder_->getShadowingMap(bsCoord);
+   if (map.empty())
+   {
+       unsigned int numPoints = 2 * (unsigned int)ceil(shadowingMapRange_ / shadowingMapResolution_) + 1;
+       double origin = -shadowingMapResolution_ * (numPoints / 2);
+       map.generate(shadowingMapRng_, bsCoord.x + origin, bsCoord.y + origin, shadowingMapResolution_, numPoints, numPoints, correlationDistance_);
+       EV << "LteRealisticChannelModel::computeShadowingFromMap - generated shadowing map for base station at " << bsCoord << endl;
+   }
+
+   double att = getShadowingStdDev(nodeId) * map.getValue(ueCoord.x, ueCoord.y);
+
+   // store the value where computeShadowing() would, as it is read by the ext-cell interference computation
+   NodeChannelState* state = (cqiDl) ? obtainUeNodeState(nodeId) : &getNodeState(nodeId);
+   if (state != nullptr)
+   {
+       state->hasShadowing = true;
+       state->shadowingTime = NOW;
+       state->shadowing = att;
+   }
+   return att;
+}
+
 double LteRealisticChannelModel::computeShadowing(double sqrDistance, MacNodeId nodeId, double speed, bool cqiDl)
 {
-    ShadowFadingMap* actualShadowingMap;
+    NodeChannelState* state;
 
-    if (cqiDl) // if we are computing a DL CQI we need the Shadowing Map stored on the UE side
-        actualShadowingMap = obtainShadowingMap(nodeId);
+    if (cqiDl) // if we are computing a DL CQI we need the Shadowing stored on the UE side
+        state = obtainUeNodeState(nodeId);
     else
-        actualShadowingMap = &lastComputedSF_;
+        state = &getNodeState(nodeId);
 
-    if (actualShadowingMap == nullptr)
-        throw cRuntimeError("LteRealisticChannelModel::computeShadowing - actualShadowingMap not found (nullptr)");
+    if (state == nullptr)
+        throw cRuntimeError("LteRealisticChannelModel::computeShadowing - node state not found (nullptr)");
 
     double mean = 0;
     double dbp = 0.0;
@@ -228,24 +359,25 @@ double LteRealisticChannelModel::computeShadowing(double sqrDistance, MacNodeId
     // the Move object associated to the UE is move variable
 
     // if shadowing for current user has never been computed
-    if (actualShadowingMap->find(nodeId) == actualShadowingMap->end())
+    if (!state->hasShadowing)
     {
         //Get the log normal shadowing with std deviation stdDev
         att = normal(mean, stdDev);
 
         //store the shadowing attenuation for this user and the temporal mark
-        std::pair<simtime_t, double> tmp(NOW, att);
-        (*actualShadowingMap)[nodeId] = tmp;
+        state->hasShadowing = true;
+        state->shadowingTime = NOW;
+        state->shadowing = att;
 
         //If the shadowing attenuation has been computed at least one time for this user
         // and the distance traveled by the UE is greated than correlation distance
     }
-    else if ((NOW - actualShadowingMap->at(nodeId).first).dbl() * speed
+    else if ((NOW - state->shadowingTime).dbl() * speed
             > correlationDistance_)
     {
 
         //get the temporal mark of the last computed shadowing attenuation
-        time = (NOW - actualShadowingMap->at(nodeId).first).dbl();
+        time = (NOW - state->shadowingTime).dbl();
 
         //compute the traveled distance
         space = time * speed;
@@ -254,20 +386,20 @@ double LteRealisticChannelModel::computeShadowing(double sqrDistance, MacNodeId
         double a = exp(-0.5 * (space / correlationDistance_));
 
         //Get last shadowing attenuation computed
-        double old = actualShadowingMap->at(nodeId).second;
+        double old = state->shadowing;
 
         //Compute shadowing with a EAW (Exponential Average Window) (step2)
         att = a * old + sqrt(1 - pow(a, 2)) * normal(mean, stdDev);
 
         // Store the new computed shadowing
-        std::pair<simtime_t, double> tmp(NOW, att);
-        (*actualShadowingMap)[nodeId] = tmp;
+        state->shadowingTime = NOW;
+        state->shadowing = att;
 
         // if the distance traveled by the UE is smaller than correlation distance shadowing attenuation remain the same
     }
     else
     {
-        att = actualShadowingMap->at(nodeId).second;
+        att = state->shadowing;
     }
 
     return att;
@@ -275,41 +407,45 @@ double LteRealisticChannelModel::computeShadowing(double sqrDistance, MacNodeId
 void LteRealisticChannelModel::updatePositionHistory(const MacNodeId nodeId,
        const Coord coord)
 {
-   if (positionHistory_.find(nodeId) != positionHistory_.end())
+   NodeChannelState& state = getNodeState(nodeId);
+   if (state.numPositions > 0)
    {
        // position already updated for this TTI.
-       if (positionHistory_[nodeId].back().first == NOW)
+       if (state.positions[state.lastPosition].first == NOW)
            return;
    }
 
-   // FIXME: possible memory leak
-   positionHistory_[nodeId].push(Position(NOW, coord));
-
-   if (positionHistory_[nodeId].size() > 2) // if we have more than a past and a current element
-       // drop the oldest one
-       positionHistory_[nodeId].pop();
+   // store the new position, overwriting the oldest one when we already have a past and a current element
+   state.lastPosition = (state.numPositions == 0) ? 0 : 1 - state.lastPosition;
+   state.positions[state.lastPosition] = Position(NOW, coord);
+   if (state.numPositions < 2)
+       state.numPositions++;
 }
 
 void LteRealisticChannelModel::updateCorrelationDistance(const MacNodeId nodeId, const inet::Coord coord){
 
-    if (lastCorrelationPoint_.find(nodeId) == lastCorrelationPoint_.end()){
+    NodeChannelState& state = getNodeState(nodeId);
+    if (!state.hasCorrelationPoint){
         // no lastCorrelationPoint set current point.
-        lastCorrelationPoint_[nodeId] = Position(NOW, coord);
-    } else if ((lastCorrelationPoint_[nodeId].first != NOW) &&
-                lastCorrelationPoint_[nodeId].second.distance(coord) > correlationDistance_) {
+        state.correlationPoint = Position(NOW, coord);
+        state.hasCorrelationPoint = true;
+    } else if ((state.correlationPoint.first != NOW) &&
+                state.correlationPoint.second.distance(coord) > correlationDistance_) {
         // check simtime_t first
-        lastCorrelationPoint_[nodeId] = Position(NOW, coord);
+        state.correlationPoint = Position(NOW, coord);
     }
 }
 
 double LteRealisticChannelModel::computeCorrelationDistance(const MacNodeId nodeId, const inet::Coord coord){
     double dist = 0.0;
 
-    if (lastCorrelationPoint_.find(nodeId) == lastCorrelationPoint_.end()){
+    NodeChannelState& state = getNodeState(nodeId);
+    if (!state.hasCorrelationPoint){
         // no lastCorrelationPoint found. Add current position and return dist = 0.0
-        lastCorrelationPoint_[nodeId] = Position(NOW, coord);
+        state.correlationPoint = Position(NOW, coord);
+        state.hasCorrelationPoint = true;
     } else {
-        dist = lastCorrelationPoint_[nodeId].second.distance(coord);
+        dist = state.correlationPoint.second.distance(coord);
     }
     return dist;
 }
@@ -319,7 +455,8 @@ double LteRealisticChannelModel::computeSpeed(const MacNodeId nodeId,
 {
    double speed = 0.0;
 
-   if (positionHistory_.find(nodeId) == positionHistory_.end())
+   NodeChannelState& state = getNodeState(nodeId);
+   if (state.numPositions == 0)
    {
        // no entries
        return speed;
@@ -328,19 +465,21 @@ double LteRealisticChannelModel::computeSpeed(const MacNodeId nodeId,
    {
        //compute distance traveled from last update by UE (eNodeB position is fixed)
 
-       if (positionHistory_[nodeId].size() == 1)
+       if (state.numPositions == 1)
        {
            //  the only element refers to present , return 0
            return speed;
        }
 
-       double movement = positionHistory_[nodeId].front().second.distance(coord);
+       // the oldest position
+       const Position& past = state.positions[1 - state.lastPosition];
+       double movement = past.second.distance(coord);
 
        if (movement <= 0.0)
            return speed;
        else
        {
-           double time = (NOW.dbl()) - (positionHistory_[nodeId].front().first.dbl());
+           double time = (NOW.dbl()) - (past.first.dbl());
            if (time <= 0.0) // time not updated since last speed call
                throw cRuntimeError("Multiple entries detected in position history referring to same time");
            // compute speed
@@ -408,44 +547,56 @@ double LteRealisticChannelModel::computeAngolarAttenuation(double hAngle, double
    return angolarAtt;
 }
 
-std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, UserControlInfo* lteInfo)
+double LteRealisticChannelModel::computeServingAngolarAttenuation(MacNodeId eNbId, MacNodeId ueId, bool cqiDl, const Coord& coord, const Coord& enbCoord, const Coord& ueCoord)
 {
-   if (useRsrqFromLog_)
-   {
-       int time = -1, rsrq = oldRsrq_;
-       double currentTime = simTime().dbl();
-       if (currentTime > oldTime_+1)
-       {
-           std::ifstream file;
+   // the angular attenuation only depends on the position of the end points, hence
+   // it can be reused for the rest of the TTI
+   LinkBudget* linkBudget = (enableLinkBudgetCache_) ? getCachedLinkBudget(ueId, cqiDl, coord, false) : nullptr;
+   if (linkBudget != nullptr && linkBudget->angolarAttValid)
+       return linkBudget->angolarAtt;
 
-           // open the rsrq file
-           file.clear();
-           file.open("rsrqFile.dat");
+   double angolarAtt = 0.0;
 
-           file >> time;
-           file >> rsrq;
+   //get tx angle
+   omnetpp::cModule* eNbModule = getSimulation()->getModule(binder_->getOmnetId(eNbId));
+   LtePhyBase* ltePhy = eNbModule ?
+      check_and_cast<LtePhyBase*>(eNbModule->getSubmodule("cellularNic")->getSubmodule("phy")) :
+      nullptr;
 
-           file.close();
+   if (ltePhy && ltePhy->getTxDirection() == ANISOTROPIC)
+   {
+       // get tx angle
+       double txAngle = ltePhy->getTxAngle();
 
-           oldTime_ = simTime().dbl();
-           oldRsrq_ = rsrq;
+       // compute the angle between uePosition and reference axis, considering the eNb as center
+       double ueAngle = computeAngle(enbCoord, ueCoord);
 
-           std::cout << "LteRealisticChannelModel::getSINR - time["<<time<<"] rsrq["<<rsrq<<"]" << endl;
-       }
+       // compute the reception angle between ue and eNb
+       double recvAngle = fabs(txAngle - ueAngle);
 
-       double sinr = rsrqScale_ * (rsrq + rsrqShift_);
-       std::vector<double> snrVector;
-       snrVector.resize(numBands_, sinr);
+       if (recvAngle > 180)
+           recvAngle = 360 - recvAngle;
 
-       return snrVector;
+       double verticalAngle = computeVerticalAngle(enbCoord, ueCoord);
+
+       // compute attenuation due to sectorial tx
+       angolarAtt = computeAngolarAttenuation(recvAngle,verticalAngle);
    }
+   // else, antenna is omni-directional
 
+   if (linkBudget != nullptr)
+   {
+       linkBudget->angolarAtt = angolarAtt;
+       linkBudget->angolarAttValid = true;
+   }
+   return angolarAtt;
+}
+
+double LteRealisticChannelModel::computeServingPower(UserControlInfo* lteInfo, SinrLinkInfo& link)
+{
    //get tx power
    double recvPower = lteInfo->getTxPower(); // dBm
 
-   //Get the Resource Blocks used to transmit this packet
-   RbMap rbmap = lteInfo->getGrantedBlocks();
-
    //get move object associated to the packet
    //this object is refereed to eNodeB if direction is DL or UE if direction is UL
    Coord coord = lteInfo->getCoord();
@@ -573,37 +724,110 @@ std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, UserCo
    //=============== ANGOLAR ATTENUATION =================
    if (dir == DL)
    {
-       //get tx angle
-       omnetpp::cModule* eNbModule = getSimulation()->getModule(binder_->getOmnetId(eNbId));
-       LtePhyBase* ltePhy = eNbModule ?
-          check_and_cast<LtePhyBase*>(eNbModule->getSubmodule("cellularNic")->getSubmodule("phy")) :
-          nullptr;
+       // compute attenuation due to sectorial tx (zero if the antenna is omni-directional)
+       recvPower -= computeServingAngolarAttenuation(eNbId, ueId, cqiDl, coord, enbCoord, ueCoord);
+   }
+   //=============== END ANGOLAR ATTENUATION =================
 
-       if (ltePhy && ltePhy->getTxDirection() == ANISOTROPIC)
-       {
-           // get tx angle
-           double txAngle = ltePhy->getTxAngle();
+   link.ueId = ueId;
+   link.eNbId = eNbId;
+   link.dir = dir;
+   link.cqiDl = cqiDl;
+   link.speed = speed;
+   link.noiseFigure = noiseFigure;
+   link.antennaGainTx = antennaGainTx;
+   link.antennaGainRx = antennaGainRx;
+   link.attenuation = attenuation;
+   link.coord = coord;
+   link.ueCoord = ueCoord;
+   link.enbCoord = enbCoord;
+
+   return recvPower;
+}
 
-           // compute the angle between uePosition and reference axis, considering the eNb as center
-           double ueAngle = computeAngle(enbCoord, ueCoord);
+void LteRealisticChannelModel::computeSinrInterference(UserControlInfo* lteInfo, const SinrLinkInfo& link, const RbMap& rbmap,
+       std::vector<double>& multiCellInterference, std::vector<double>& bgCellInterference, std::vector<double>& extCellInterference)
+{
+   //============ MULTI CELL INTERFERENCE COMPUTATION =================
+   // prepare data structure
+   multiCellInterference.assign(numBands_, 0);
+   if (enableDownlinkInterference_ && link.dir == DL && lteInfo->getFrameType() != HANDOVERPKT)
+   {
+       computeDownlinkInterference(link.eNbId, link.ueId, link.ueCoord, (lteInfo->getFrameType() == FEEDBACKPKT), lteInfo->getCarrierFrequency(), rbmap, &multiCellInterference);
+   }
+   else if (enableUplinkInterference_ && link.dir == UL)
+   {
+       computeUplinkInterference(link.eNbId, link.ueId, (lteInfo->getFrameType() == FEEDBACKPKT), lteInfo->getCarrierFrequency(), rbmap, &multiCellInterference);
+   }
 
-           // compute the reception angle between ue and eNb
-           double recvAngle = fabs(txAngle - ueAngle);
+   //============ BACKGROUND CELLS INTERFERENCE COMPUTATION =================
+   // prepare data structure
+   bgCellInterference.assign(numBands_, 0);
+   if (enableBackgroundCellInterference_)
+   {
+       computeBackgroundCellInterference(link.ueId, link.enbCoord, link.ueCoord, (lteInfo->getFrameType() == FEEDBACKPKT), lteInfo->getCarrierFrequency(), rbmap, link.dir, &bgCellInterference); // dBm
+   }
 
-           if (recvAngle > 180)
-               recvAngle = 360 - recvAngle;
+   //============ EXTCELL INTERFERENCE COMPUTATION =================
+   // TODO this might be obsolete as it is replaced by background cell interference
+   // prepare data structure
+   extCellInterference.assign(numBands_, 0);
+   if (enableExtCellInterference_ && link.dir == DL)
+   {
+       computeExtCellInterference(link.eNbId, link.ueId, link.ueCoord, (lteInfo->getFrameType() == FEEDBACKPKT), lteInfo->getCarrierFrequency(), &extCellInterference); // dBm
+   }
+}
 
-           double verticalAngle = computeVerticalAngle(enbCoord, ueCoord);
+std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, UserControlInfo* lteInfo)
+{
+   if (useRsrqFromLog_)
+   {
+       int time = -1, rsrq = oldRsrq_;
+       double currentTime = simTime().dbl();
+       if (currentTime > oldTime_+1)
+       {
+           std::ifstream file;
 
-           // compute attenuation due to sectorial tx
-           double angolarAtt = computeAngolarAttenuation(recvAngle,verticalAngle);
+           // open the rsrq file
+           file.clear();
+           file.open("rsrqFile.dat");
 
-           recvPower -= angolarAtt;
+           file >> time;
+           file >> rsrq;
+
+           file.close();
+
+           oldTime_ = simTime().dbl();
+           oldRsrq_ = rsrq;
+
+           std::cout << "LteRealisticChannelModel::getSINR - time["<<time<<"] rsrq["<<rsrq<<"]" << endl;
        }
-       // else, antenna is omni-directional
+
+       double sinr = rsrqScale_ * (rsrq + rsrqShift_);
+       std::vector<double> snrVector;
+       snrVector.resize(numBands_, sinr);
+
+       return snrVector;
    }
-   //=============== END ANGOLAR ATTENUATION =================
 
+   //Get the Resource Blocks used to transmit this packet
+   RbMap rbmap = lteInfo->getGrantedBlocks();
+
+   //============ PATH LOSS + SHADOWING + ANGOLAR ATTENUATION ============
+   SinrLinkInfo link;
+   double recvPower = computeServingPower(lteInfo, link); // dBm
+
+   MacNodeId ueId = link.ueId;
+   Direction dir = link.dir;
+   bool cqiDl = link.cqiDl;
+   double speed = link.speed;
+   double noiseFigure = link.noiseFigure;
+   double antennaGainTx = link.antennaGainTx;
+   double antennaGainRx = link.antennaGainRx;
+   double attenuation = link.attenuation;
+   Coord coord = link.coord;
+   Coord ueCoord = link.ueCoord;
+   Coord enbCoord = link.enbCoord;
 
    std::vector<double> snrVector;
    snrVector.resize(numBands_, 0.0);
@@ -614,21 +838,15 @@ std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, UserCo
    // if the phy layer is distributed the number of logical band should be set to 1
    double fadingAttenuation = 0;
 
+   // compute the fading attenuation for all the bands at once
+   computeFading(ueId, speed, cqiDl, fadingAttenuation_);
+
    // for each logical band
    // FIXME compute fading only for used RBs
    for (unsigned int i = 0; i < numBands_; i++)
    {
-       fadingAttenuation = 0;
-       //if fading is enabled
-       if (fading_)
-       {
-           //Appling fading
-           if (fadingType_ == RAYLEIGH)
-               fadingAttenuation = rayleighFading(ueId, i);
-
-           else if (fadingType_ == JAKES)
-               fadingAttenuation = jakesFading(ueId, speed, i, cqiDl);
-       }
+       // fading attenuation is zero if fading is disabled
+       fadingAttenuation = fadingAttenuation_[i];
        // add fading contribution to the received pwr
        double finalRecvPower = recvPower + fadingAttenuation; // (dBm+dB)=dBm
 
@@ -666,40 +884,12 @@ std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, UserCo
     * I = extCellInterference + multiCellInterference
     */
 
-   //============ MULTI CELL INTERFERENCE COMPUTATION =================
-   //vector containing the sum of multicell interference for each band
+   //============ INTERFERENCE COMPUTATION =================
+   //vectors containing the sum of multicell, bg-cell and ext-cell interference for each band
    std::vector<double> multiCellInterference; // Linear value (mW)
-   // prepare data structure
-   multiCellInterference.resize(numBands_, 0);
-   if (enableDownlinkInterference_ && dir == DL && lteInfo->getFrameType() != HANDOVERPKT)
-   {
-       computeDownlinkInterference(eNbId, ueId, ueCoord, (lteInfo->getFrameType() == FEEDBACKPKT), lteInfo->getCarrierFrequency(), rbmap, &multiCellInterference);
-   }
-   else if (enableUplinkInterference_ && dir == UL)
-   {
-       computeUplinkInterference(eNbId, ueId, (lteInfo->getFrameType() == FEEDBACKPKT), lteInfo->getCarrierFrequency(), rbmap, &multiCellInterference);
-   }
-
-   //============ BACKGROUND CELLS INTERFERENCE COMPUTATION =================
-   //vector containing the sum of bg-cell interference for each band
    std::vector<double> bgCellInterference; // Linear value (mW)
-   // prepare data structure
-   bgCellInterference.resize(numBands_, 0);
-   if (enableBackgroundCellInterference_)
-   {
-       computeBackgroundCellInterference(ueId, enbCoord, ueCoord, (lteInfo->getFrameType() == FEEDBACKPKT), lteInfo->getCarrierFrequency(), rbmap, dir, &bgCellInterference); // dBm
-   }
-
-   //============ EXTCELL INTERFERENCE COMPUTATION =================
-   // TODO this might be obsolete as it is replaced by background cell interference
-   //vector containing the sum of ext-cell interference for each band
    std::vector<double> extCellInterference; // Linear value (mW)
-   // prepare data structure
-   extCellInterference.resize(numBands_, 0);
-   if (enableExtCellInterference_ && dir == DL)
-   {
-       computeExtCellInterference(eNbId, ueId, ueCoord, (lteInfo->getFrameType() == FEEDBACKPKT), lteInfo->getCarrierFrequency(), &extCellInterference); // dBm
-   }
+   computeSinrInterference(lteInfo, link, rbmap, multiCellInterference, bgCellInterference, extCellInterference);
 
    //===================== SINR COMPUTATION ========================
    // compute and linearize total noise
@@ -756,6 +946,237 @@ std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, UserCo
    return snrVector;
 }
 
+double LteRealisticChannelModel::getMeanSINR(LteAirFrame *frame, UserControlInfo* lteInfo)
+{
+   // the fast path is only available for feedback computation without per-band fading
+   if (useRsrqFromLog_ || fading_ || lteInfo->getFrameType() != FEEDBACKPKT)
+       return LteChannelModel::getMeanSINR(frame, lteInfo);
+
+   EV << "------------ GET MEAN SINR ----------------" << endl;
+
+   //Get the Resource Blocks used to transmit this packet
+   RbMap rbmap = lteInfo->getGrantedBlocks();
+
+   SinrLinkInfo link;
+   double recvPower = computeServingPower(lteInfo, link); // dBm
+
+   //if txmode is multi user the tx power is dived by the number of paired user
+   // in db divede by 2 means -3db
+   if (lteInfo->getTxMode() == MULTI_USER)
+       recvPower -= 3;
+
+   computeSinrInterference(lteInfo, link, rbmap, multiCellInterference_, bgCellInterference_, extCellInterference_);
+
+   // compute and linearize total noise
+   double totN = dBmToLinear(thermalNoise_ + link.noiseFigure);
+
+   // without fading, the received power is the same on all the bands: accumulate the
+   // SINR of each band in the same order as getSINR()
+   double sumSnr = 0.0;
+   for (unsigned int i = 0; i < numBands_; i++)
+   {
+       //               (      mW               +          mW             +  mW  +        mW             )
+       double den = linearToDBm(bgCellInterference_[i] + extCellInterference_[i] + totN + multiCellInterference_[i]);
+       sumSnr += recvPower - den;
+   }
+
+   // emit SINR statistic
+   if (collectSinrStatistics_ && numBands_ > 0)
+   {
+       // we are on the BS, so we need to retrieve the channel model of the sender
+       LteChannelModel* ueChannelModel = check_and_cast<LtePhyUe*>(getPhyByMacNodeId(link.ueId))->getChannelModel(lteInfo->getCarrierFrequency());
+
+       if (link.dir == DL)
+           ueChannelModel->emit(measuredSinrDl_, sumSnr / numBands_);
+       else
+           ueChannelModel->emit(measuredSinrUl_, sumSnr / numBands_);
+   }
+
+   //if sender is an eNodeB
+   if (link.dir == DL)
+       //store the position of user
+       updatePositionHistory(link.ueId, phy_->getCoord());
+   //sender is an UE
+   else
+       updatePositionHistory(link.ueId, link.coord);
+
+   EV << "LteRealisticChannelModel::getMeanSINR - ueId[" << link.ueId << "] - mean sinr " << sumSnr / numBands_ << endl;
+
+   return sumSnr / numBands_;
+}
+
+double LteRealisticChannelModel::getWidebandSNR(LteAirFrame *frame, UserControlInfo* lteInfo)
+{
+   Direction dir = (Direction) lteInfo->getDirection();
+   if (useRsrqFromLog_ || dir != DL || lteInfo->getFrameType() == FEEDBACKPKT)
+       return LteChannelModel::getWidebandSNR(frame, lteInfo);
+
+   // this function is called by the UE: the eNB is the sender
+   MacNodeId ueId = lteInfo->getDestId();
+   MacNodeId eNbId = lteInfo->getSourceId();
+   Coord coord = lteInfo->getCoord();
+   Coord ueCoord = phy_->getCoord();
+   Coord enbCoord = coord;
+
+   //get tx power
+   double recvPower = lteInfo->getTxPower(); // dBm
+
+   // attenuation for the desired signal
+   double attenuation = getAttenuation(ueId, dir, coord, false); // dB
+
+   //compute attenuation (PATHLOSS + SHADOWING)
+   recvPower -= attenuation; // (dBm-dB)=dBm
+
+   //add antenna gain
+   recvPower += antennaGainEnB_; // (dBm+dB)=dBm
+   recvPower += antennaGainUe_; // (dBm+dB)=dBm
+
+   //sub cable loss
+   recvPower -= cableLoss_; // (dBm-dB)=dBm
+
+   // compute attenuation due to sectorial tx (zero if the antenna is omni-directional)
+   recvPower -= computeServingAngolarAttenuation(eNbId, ueId, false, coord, enbCoord, ueCoord);
+
+   double snr = recvPower - (thermalNoise_ + ueNoiseFigure_);
+
+   EV << "LteRealisticChannelModel::getWidebandSNR - ueId[" << ueId << "] - enbId[" << eNbId << "] - recvPower " << recvPower
+      << " - attenuation (pathloss + shadowing) " << attenuation << " - snr " << snr << endl;
+
+   //store the position of user
+   updatePositionHistory(ueId, phy_->getCoord());
+
+   return snr;
+}
+
+std::vector<std::vector<double> > LteRealisticChannelModel::getSINRBatch(MacCellId cellId, const std::vector<MacNodeId>& ueIds, double carrierFrequency,
+        const std::vector<UserControlInfo*>& reports)
+{
+   if (useRsrqFromLog_ || cellId != phy_->getMacNodeId())
+       return LteChannelModel::getSINRBatch(cellId, ueIds, carrierFrequency, reports);
+   if (reports.size() != ueIds.size())
+       throw cRuntimeError("LteRealisticChannelModel::getSINRBatch - %d reports for %d UEs", (int)reports.size(), (int)ueIds.size());
+
+   EV << "------------ GET SINR BATCH ----------------" << endl;
+
+   std::vector<std::vector<double> > sinr(ueIds.size());
+
+   //===================== SHARED PARAMETERS ============================
+   // the cell transmits, the UEs receive
+   double noiseFigure = ueNoiseFigure_; //dB
+   double antennaGainTx = antennaGainEnB_; //dB
+   double antennaGainRx = antennaGainUe_;  //dB
+   Coord enbCoord = phy_->getCoord();
+
+   // compute and linearize total noise
+   double totN = dBmToLinear(thermalNoise_ + noiseFigure);
+
+   // the interfering cells and their band occupation are evaluated when the batch is computed.
+   // Cells beyond the cutoff distance are skipped for each UE, so that the interferers of each UE
+   // are the same, and in the same order, as those evaluated by getSINR()
+   if (enableDownlinkInterference_)
+       prepareDownlinkInterferers(cellId, nullptr, true, carrierFrequency, feedbackBatchInterferers_);
+   //=================== END SHARED PARAMETERS =======================
+
+   for (unsigned int k = 0; k < ueIds.size(); k++)
+   {
+       UserControlInfo* info = reports[k];
+       MacNodeId ueId = ueIds[k];
+       // the batch evaluation is only possible for DL feedback of the UEs of this cell
+       if (info->getSourceId() != ueId || info->getDirection() != DL || info->getFrameType() != FEEDBACKPKT
+               || info->getDestId() != cellId || info->getCarrierFrequency() != carrierFrequency)
+       {
+           sinr[k] = LteChannelModel::getSINRBatch(cellId, std::vector<MacNodeId>(1, ueId), carrierFrequency, std::vector<UserControlInfo*>(1, info)).front();
+           continue;
+       }
+
+       // the feedback carries the position of the UE
+       Coord ueCoord = info->getCoord();
+       double speed = computeSpeed(ueId, ueCoord);
+       RbMap rbmap = info->getGrantedBlocks();
+
+       //=============== PATH LOSS + SHADOWING + FADING =================
+       // attenuation for the desired signal (use the jakes map in the UE side)
+       double attenuation = getAttenuation(ueId, UL, ueCoord, true); // dB
+
+       // same order of operations as computeServingPower()
+       double recvPower = info->getTxPower(); // dBm
+       recvPower -= attenuation; // (dBm-dB)=dBm
+       recvPower += antennaGainTx; // (dBm+dB)=dBm
+       recvPower += antennaGainRx; // (dBm+dB)=dBm
+       recvPower -= cableLoss_; // (dBm-dB)=dBm
+
+       // compute attenuation due to sectorial tx (zero if the antenna is omni-directional)
+       recvPower -= computeServingAngolarAttenuation(cellId, ueId, true, ueCoord, enbCoord, ueCoord);
+
+       // wideband feedback without fading only needs the SINR averaged over the bands, computed
+       // as getMeanSINR() does. Otherwise, the SINR of each band is computed as getSINR() does
+       bool meanOnly = (info->feedbackReq.type == WIDEBAND && !fading_);
+       bool multiUser = (info->getTxMode() == MULTI_USER);
+       if (!meanOnly)
+           computeFading(ueId, speed, true, fadingAttenuation_);
+       else if (multiUser)
+           recvPower -= 3;
+
+       EV << "LteRealisticChannelModel::getSINRBatch - ueId[" << ueId << "] - ueCoord[" << ueCoord << "] - recvPower " << recvPower
+          << " - attenuation (pathloss + shadowing) " << attenuation << " - speed " << speed << endl;
+       //============ END PATH LOSS + SHADOWING + FADING ===============
+
+       //============ INTERFERENCE COMPUTATION =================
+       multiCellInterference_.assign(numBands_, 0);
+       if (enableDownlinkInterference_)
+           addDownlinkInterference(ueId, ueCoord, true, rbmap, feedbackBatchInterferers_, &multiCellInterference_);
+
+       bgCellInterference_.assign(numBands_, 0);
+       if (enableBackgroundCellInterference_)
+           computeBackgroundCellInterference(ueId, enbCoord, ueCoord, true, carrierFrequency, rbmap, DL, &bgCellInterference_); // dBm
+
+       extCellInterference_.assign(numBands_, 0);
+       if (enableExtCellInterference_)
+           computeExtCellInterference(cellId, ueId, ueCoord, true, carrierFrequency, &extCellInterference_); // dBm
+
+       //===================== SINR COMPUTATION ========================
+       std::vector<double>& snrVector = sinr[k];
+       if (!meanOnly)
+           snrVector.resize(numBands_);
+       double sumSnr = 0.0;
+       for (unsigned int i = 0; i < numBands_; i++)
+       {
+           //               (      mW               +          mW             +  mW  +        mW             )
+           double den = linearToDBm(bgCellInterference_[i] + extCellInterference_[i] + totN + multiCellInterference_[i]);
+
+           double snr;
+           if (meanOnly)
+               snr = recvPower - den;
+           else
+           {
+               double finalRecvPower = recvPower + fadingAttenuation_[i]; // (dBm+dB)=dBm
+               if (multiUser)
+                   finalRecvPower -= 3;
+               snr = finalRecvPower - den;
+               snrVector[i] = snr;
+           }
+           sumSnr += snr;
+       }
+
+       // wideband feedback only uses the SINR averaged over the bands
+       if (info->feedbackReq.type == WIDEBAND)
+           snrVector.assign(1, sumSnr / numBands_);
+
+       // emit SINR statistic
+       if (collectSinrStatistics_ && numBands_ > 0)
+       {
+           LteRealisticChannelModel* ueChannelModel = binder_->getUeChannelModel(ueId, carrierFrequency);
+           if (ueChannelModel != nullptr)
+               ueChannelModel->emit(measuredSinrDl_, sumSnr / numBands_);
+       }
+
+       // store the position of user (as getSINR() does for DL directions)
+       updatePositionHistory(ueId, phy_->getCoord());
+   }
+
+   return sinr;
+}
+
 std::vector<double> LteRealisticChannelModel::getRSRP(LteAirFrame *frame, UserControlInfo* lteInfo)
 {
    if (useRsrqFromLog_)
@@ -921,34 +1342,8 @@ std::vector<double> LteRealisticChannelModel::getRSRP(LteAirFrame *frame, UserCo
    //=============== ANGOLAR ATTENUATION =================
    if (dir == DL)
    {
-       //get tx angle
-       omnetpp::cModule* eNbModule = getSimulation()->getModule(binder_->getOmnetId(eNbId));
-       LtePhyBase* ltePhy = eNbModule ?
-          check_and_cast<LtePhyBase*>(eNbModule->getSubmodule("cellularNic")->getSubmodule("phy")) :
-          nullptr;
-
-       if (ltePhy && ltePhy->getTxDirection() == ANISOTROPIC)
-       {
-           // get tx angle
-           double txAngle = ltePhy->getTxAngle();
-
-           // compute the angle between uePosition and reference axis, considering the eNb as center
-           double ueAngle = computeAngle(enbCoord, ueCoord);
-
-           // compute the reception angle between ue and eNb
-           double recvAngle = fabs(txAngle - ueAngle);
-
-           if (recvAngle > 180)
-               recvAngle = 360 - recvAngle;
-
-           double verticalAngle = computeVerticalAngle(enbCoord, ueCoord);
-
-           // compute attenuation due to sectorial tx
-           double angolarAtt = computeAngolarAttenuation(recvAngle,verticalAngle);
-
-           recvPower -= angolarAtt;
-       }
-       // else, antenna is omni-directional
+       // compute attenuation due to sectorial tx (zero if the antenna is omni-directional)
+       recvPower -= computeServingAngolarAttenuation(eNbId, ueId, cqiDl, coord, enbCoord, ueCoord);
    }
    //=============== END ANGOLAR ATTENUATION =================
 
@@ -961,21 +1356,15 @@ std::vector<double> LteRealisticChannelModel::getRSRP(LteAirFrame *frame, UserCo
    // if the phy layer is distributed the number of logical band should be set to 1
    double fadingAttenuation = 0;
 
+   // compute the fading attenuation for all the bands at once
+   computeFading(ueId, speed, cqiDl, fadingAttenuation_);
+
    // for each logical band
    // FIXME compute fading only for used RBs
    for (unsigned int i = 0; i < numBands_; i++)
    {
-       fadingAttenuation = 0;
-       //if fading is enabled
-       if (fading_)
-       {
-           //Appling fading
-           if (fadingType_ == RAYLEIGH)
-               fadingAttenuation = rayleighFading(ueId, i);
-
-           else if (fadingType_ == JAKES)
-               fadingAttenuation = jakesFading(ueId, speed, i, cqiDl);
-       }
+       // fading attenuation is zero if fading is disabled
+       fadingAttenuation = fadingAttenuation_[i];
        // add fading contribution to the received pwr
        double finalRecvPower = recvPower + fadingAttenuation; // (dBm+dB)=dBm
 
@@ -1118,20 +1507,13 @@ std::vector<double> LteRealisticChannelModel::getSINR_bgUe(LteAirFrame *frame, U
    std::vector<double> snrVector;
    snrVector.resize(numBands_, recvPower);
 
-   // for each logical band
    double fadingAttenuation = 0;
+   computeFading(bgUeId, speed, cqiDl, fadingAttenuation_, true);
+   // for each logical band
    for (unsigned int i = 0; i < numBands_; i++)
    {
-       //if fading is enabled
-       if (fading_)
-       {
-           //Appling fading
-           if (fadingType_ == RAYLEIGH)
-               fadingAttenuation = rayleighFading(bgUeId, i);
-
-           else if (fadingType_ == JAKES)
-               fadingAttenuation = jakesFading(bgUeId, speed, i, cqiDl, true);
-       }
+       // fading attenuation is zero if fading is disabled
+       fadingAttenuation = fadingAttenuation_[i];
        // add fading contribution to the received pwr
        double finalRecvPower = recvPower + fadingAttenuation; // (dBm+dB)=dBm
 
@@ -1379,22 +1761,12 @@ std::vector<double> LteRealisticChannelModel::getRSRP_D2D(LteAirFrame *frame, Us
    // if the phy layer is localized we can assume that for each logical band we have different fading attenuation
    // if the phy layer is distributed the number of logical band should be set to 1
    double fadingAttenuation = 0;
+   computeFading(sourceId, speed, cqiDl, fadingAttenuation_);
    //for each logical band
    for (unsigned int i = 0; i < numBands_; i++)
    {
-       fadingAttenuation = 0;
-       //if fading is enabled
-       if (fading_)
-       {
-           //Appling fading
-           if (fadingType_ == RAYLEIGH)
-               fadingAttenuation = rayleighFading(sourceId, i);
-
-           else if (fadingType_ == JAKES)
-           {
-               fadingAttenuation = jakesFading(sourceId, speed, i, cqiDl);
-           }
-       }
+       // fading attenuation is zero if fading is disabled
+       fadingAttenuation = fadingAttenuation_[i];
        // add fading contribution to the received pwr
        double finalRecvPower = recvPower + fadingAttenuation; // (dBm+dB)=dBm
 
@@ -1497,22 +1869,12 @@ std::vector<double> LteRealisticChannelModel::getSINR_D2D(LteAirFrame *frame, Us
    // if the phy layer is localized we can assume that for each logical band we have different fading attenuation
    // if the phy layer is distributed the number of logical band should be set to 1
    double fadingAttenuation = 0;
+   computeFading(sourceId, speed, cqiDl, fadingAttenuation_);
    //for each logical band
    for (unsigned int i = 0; i < numBands_; i++)
-   {
-       fadingAttenuation = 0;
-       //if fading is enabled
-       if (fading_)
-       {
-           //Appling fading
-           if (fadingType_ == RAYLEIGH)
-               fadingAttenuation = rayleighFading(sourceId, i);
-
-           else if (fadingType_ == JAKES)
-           {
-               fadingAttenuation = jakesFading(sourceId, speed, i, cqiDl);
-           }
-       }
+   {
+       // fading attenuation is zero if fading is disabled
+       fadingAttenuation = fadingAttenuation_[i];
        // add fading contribution to the received pwr
        double finalRecvPower = recvPower + fadingAttenuation; // (dBm+dB)=dBm
 
@@ -1767,23 +2129,12 @@ std::vector<double> LteRealisticChannelModel::getSIR(LteAirFrame *frame,
    std::vector<double> snrVector;
 
    double fadingAttenuation = 0;
+   computeFading(id, speed, dir, fadingAttenuation_);
    //for each logical band
    for (unsigned int i = 0; i < numBands_; i++)
    {
-       fadingAttenuation = 0;
-       //if fading is enabled
-       if (fading_)
-       {
-           //Applying fading
-           if (fadingType_ == RAYLEIGH)
-           {
-               fadingAttenuation = rayleighFading(id, i);
-           }
-           else if (fadingType_ == JAKES)
-           {
-               fadingAttenuation = jakesFading(id, speed, i, dir);
-           }
-       }
+       // fading attenuation is zero if fading is disabled
+       fadingAttenuation = fadingAttenuation_[i];
        // add fading contribution to the final Sinr
        double finalSnr = recvPower + fadingAttenuation;
 
@@ -1814,8 +2165,7 @@ double LteRealisticChannelModel::rayleighFading(MacNodeId id,
    return linearToDb(temp1);
 }
 
-double LteRealisticChannelModel::jakesFading(MacNodeId nodeId, double speed,
-       unsigned int band, bool cqiDl, bool isBgUe)
+LteRealisticChannelModel::JakesFadingData* LteRealisticChannelModel::obtainJakesFadingData(MacNodeId nodeId, bool cqiDl, bool isBgUe)
 {
    /**
     * NOTE: there are two different jakes map. One on the Ue side and one on the eNb side, with different values.
@@ -1829,83 +2179,158 @@ double LteRealisticChannelModel::jakesFading(MacNodeId nodeId, double speed,
     * thus the actual map should be choosen carefully (i.e. just check the cqiDL flag)
     */
    JakesFadingMap* actualJakesMap;
+   // state of the node within the channel model owning the map (not used for background UEs)
+   NodeChannelState* state = nullptr;
 
-   if (cqiDl) // if we are computing a DL CQI we need the Jakes Map stored on the UE side
-       actualJakesMap = (!isBgUe) ? obtainUeJakesMap(nodeId) : &jakesFadingMapBgUe_;
+   if (cqiDl && isBgUe)
+   {
+       actualJakesMap = &jakesFadingMapBgUe_;
+       JakesFadingMap::iterator it = actualJakesMap->find(nodeId);
+       if (it != actualJakesMap->end())
+           return &(it->second);
+   }
    else
-       actualJakesMap = &jakesFadingMap_;
-
-   //if this is the first time that we compute fading for current user
-   if (actualJakesMap->find(nodeId) == actualJakesMap->end())
    {
-       //clear the map
-       // FIXME: possible memory leak
-       (*actualJakesMap)[nodeId].clear();
+       // if we are computing a DL CQI we need the Jakes Map stored on the UE side
+       LteRealisticChannelModel* owner = (cqiDl) ? obtainUeChannelModel(nodeId) : this;
+       if (owner == nullptr)
+           throw cRuntimeError("LteRealisticChannelModel::obtainJakesFadingData - jakes map not found for node %d", nodeId);
 
-       //for each band we are going to create a jakes fading
-       for (unsigned int j = 0; j < numBands_; j++)
-       {
-           //clear some structure
-           JakesFadingData temp;
-           temp.angleOfArrival.clear();
-           temp.delaySpread.clear();
+       state = &(owner->getNodeState(nodeId));
+       if (state->jakesFading != nullptr)
+           return state->jakesFading;
+       actualJakesMap = owner->getJakesMap();
+   }
 
-           //for each fading path
-           for (int i = 0; i < fadingPaths_; i++)
-           {
-               //get angle of arrivals
-               temp.angleOfArrival.push_back(cos(uniform(0, M_PI)));
+   //this is the first time that we compute fading for current user
+   JakesFadingData& data = (*actualJakesMap)[nodeId];
+   if (state != nullptr)
+       state->jakesFading = &data;
+   data.numBands = numBands_;
+   data.angleOfArrival.resize(fadingPaths_ * numBands_);
+   data.delayPhase.resize(fadingPaths_ * numBands_);
+   data.lastTime = -1;
+   data.lastSpeed = 0.0;
 
-               //get delay spread
-               temp.delaySpread.push_back(exponential(delayRMS_));
-           }
-           //store the jakes fadint for this user
-           (*actualJakesMap)[nodeId].push_back(temp);
+   // convert carrier frequency from GHz to Hz
+   double f = carrierFrequency_ * 1000000000;
+
+   //for each band we are going to create a jakes fading
+   for (unsigned int j = 0; j < numBands_; j++)
+   {
+       //for each fading path
+       for (int i = 0; i < fadingPaths_; i++)
+       {
+           //get angle of arrivals
+           data.angleOfArrival[i * numBands_ + j] = cos(uniform(0, M_PI));
+
+           //get delay spread (rounded to the simulation time resolution) and
+           //store the resulting phase shift => f-selectivity
+           simtime_t delaySpread = exponential(delayRMS_);
+           data.delayPhase[i * numBands_ + j] = delaySpread.dbl() * f;
        }
    }
+   return &data;
+}
+
+double LteRealisticChannelModel::jakesFading(MacNodeId nodeId, double speed,
+       unsigned int band, bool cqiDl, bool isBgUe)
+{
+   computeJakesFading(nodeId, speed, cqiDl, jakesFadingBuffer_, isBgUe);
+   return jakesFadingBuffer_.at(band);
+}
+
+void LteRealisticChannelModel::computeJakesFading(MacNodeId nodeId, double speed, bool cqiDl, std::vector<double>& fading, bool isBgUe)
+{
+   JakesFadingData* data = obtainJakesFadingData(nodeId, cqiDl, isBgUe);
+   unsigned int numBands = data->numBands;
+
+   // the data may have been created by the channel model of the UE, while the callers
+   // read numBands_ values from the output without bound checks
+   if (numBands != numBands_)
+       throw cRuntimeError("LteRealisticChannelModel::computeJakesFading - jakes data of node %d has %d bands, %d expected", nodeId, numBands, numBands_);
+
+   // the fading only depends on the time and on the speed of the node, hence
+   // it can be reused if it has already been computed in this TTI
+   if (memoizeFading_ && data->lastTime == NOW && data->lastSpeed == speed)
+   {
+       fading = data->lastFading;
+       return;
+   }
+
    // convert carrier frequency from GHz to Hz
    double f = carrierFrequency_ * 1000000000;
 
    //get transmission time start (TTI =1ms)
    simtime_t t = simTime().dbl() - 0.001;
-
-   double re_h = 0;
-   double im_h = 0;
-
-   const JakesFadingData& actualJakesData = actualJakesMap->at(nodeId).at(band);
+   double time = t.dbl();
 
    // Compute Doppler shift.
    double doppler_shift = (speed * f) / SPEED_OF_LIGHT;
 
-   for (int i = 0; i < fadingPaths_; i++)
-   {
-       // Phase shift due to Doppler => t-selectivity.
-       double phi_d = actualJakesData.angleOfArrival[i] * doppler_shift;
+   // One ring model/Clarke's model plus f-selectivity according to Cavers:
+   // Due to isotropic antenna gain pattern on all paths only a^2 can be received on all paths.
+   // Since we are interested in attenuation a:=1, attenuation per path is then:
+   double attenuation = (1.00 / sqrt(static_cast<double>(fadingPaths_)));
 
-       // Phase shift due to delay spread => f-selectivity.
-       double phi_i = actualJakesData.delaySpread[i].dbl() * f;
+   jakesRe_.assign(numBands, 0.0);
+   jakesIm_.assign(numBands, 0.0);
+   double* re_h = jakesRe_.data();
+   double* im_h = jakesIm_.data();
 
-       // Calculate resulting phase due to t-selective and f-selective fading.
-       double phi = 2.00 * M_PI * (phi_d * t.dbl() - phi_i);
+   // process one path at a time for all the bands, so that the inner loop
+   // works on contiguous data and can be vectorized
+   for (int i = 0; i < fadingPaths_; i++)
+   {
+       const double* angleOfArrival = data->angleOfArrival.data() + i * numBands;
+       const double* delayPhase = data->delayPhase.data() + i * numBands;
 
-       // One ring model/Clarke's model plus f-selectivity according to Cavers:
-       // Due to isotropic antenna gain pattern on all paths only a^2 can be received on all paths.
-       // Since we are interested in attenuation a:=1, attenuation per path is then:
-       double attenuation = (1.00 / sqrt(static_cast<double>(fadingPaths_)));
+       for (unsigned int b = 0; b < numBands; b++)
+       {
+           // Phase shift due to Doppler => t-selectivity.
+           double phi_d = angleOfArrival[b] * doppler_shift;
 
-       // Convert to cartesian form and aggregate {Re, Im} over all fading paths.
-       re_h = re_h + attenuation * cos(phi);
-       im_h = im_h - attenuation * sin(phi);
+           // Calculate resulting phase due to t-selective and f-selective fading.
+           double phi = 2.00 * M_PI * (phi_d * time - delayPhase[b]);
 
-       //        EV << "ID=" << nodeId << " - t[" << t << "] - dopplerShift[" << doppler_shift << "] - phiD[" <<
-       //                phi_d << "] - phiI[" << phi_i << "] - phi[" << phi << "] - attenuation[" << attenuation << "] - f["
-       //                << f << "] - Band[" << band << "] - cos(phi)["
-       //                << cos(phi) << "]" << endl;
+           // Convert to cartesian form and aggregate {Re, Im} over all fading paths.
+           re_h[b] = re_h[b] + attenuation * cos(phi);
+           im_h[b] = im_h[b] - attenuation * sin(phi);
+       }
    }
 
    // Output: |H_f|^2 = absolute channel impulse response due to fading.
    // Note that this may be >1 due to constructive interference.
-   return linearToDb(re_h * re_h + im_h * im_h);
+   fading.resize(numBands);
+   for (unsigned int b = 0; b < numBands; b++)
+       fading[b] = linearToDb(re_h[b] * re_h[b] + im_h[b] * im_h[b]);
+
+   if (memoizeFading_)
+   {
+       data->lastTime = NOW;
+       data->lastSpeed = speed;
+       data->lastFading = fading;
+   }
+}
+
+void LteRealisticChannelModel::computeFading(MacNodeId nodeId, double speed, bool cqiDl, std::vector<double>& fading, bool isBgUe)
+{
+   if (!fading_)
+   {
+       fading.assign(numBands_, 0.0);
+       return;
+   }
+
+   if (fadingType_ == JAKES)
+   {
+       computeJakesFading(nodeId, speed, cqiDl, fading, isBgUe);
+       return;
+   }
+
+   // RAYLEIGH
+   fading.resize(numBands_);
+   for (unsigned int i = 0; i < numBands_; i++)
+       fading[i] = rayleighFading(nodeId, i);
 }
 
 bool LteRealisticChannelModel::isError(LteAirFrame *frame, UserControlInfo* lteInfo)
@@ -2011,7 +2436,9 @@ bool LteRealisticChannelModel::isError(LteAirFrame *frame, UserControlInfo* lteI
            sumSnr += snrV[jt->first];
            usedRBs++;
 
-           int snr = snrV[jt->first];//XXX because jt->first is a Band (=unsigned short)
+           // truncate the SINR to the resolution of the BLER tables
+           double resolution = binder_->phyPisaData.getBlerTableResolution();
+           double snr = trunc(snrV[jt->first] / resolution) * resolution;//XXX because jt->first is a Band (=unsigned short)
            if (snr < binder_->phyPisaData.minSnr())
                return false;
            else if (snr > binder_->phyPisaData.maxSnr())
@@ -2186,7 +2613,9 @@ bool LteRealisticChannelModel::isError_D2D(LteAirFrame *frame, UserControlInfo*
            sumSnr += snrV[jt->first];
            usedRBs++;
 
-           int snr = snrV[jt->first];//XXX because jt->first is a Band (=unsigned short)
+           // truncate the SINR to the resolution of the BLER tables
+           double resolution = binder_->phyPisaData.getBlerTableResolution();
+           double snr = trunc(snrV[jt->first] / resolution) * resolution;//XXX because jt->first is a Band (=unsigned short)
            if (snr < 1)   // XXX it was < 0
                return false;
            else if (snr > binder_->phyPisaData.maxSnr())
@@ -2247,7 +2676,7 @@ void LteRealisticChannelModel::computeLosProbability(double d,
    double p = 0;
    if (!dynamicLos_)
    {
-       losMap_[nodeId] = fixedLos_;
+       setLos(nodeId, fixedLos_);
        return;
    }
    switch (scenario_)
@@ -2285,9 +2714,9 @@ void LteRealisticChannelModel::computeLosProbability(double d,
    }
    double random = uniform(0.0, 1.0);
    if (random <= p)
-       losMap_[nodeId] = true;
+       setLos(nodeId, true);
    else
-       losMap_[nodeId] = false;
+       setLos(nodeId, false);
 }
 
 double LteRealisticChannelModel::computePathLoss(double distance, double dbp, bool los)
@@ -2317,6 +2746,125 @@ double LteRealisticChannelModel::computePathLoss(double distance, double dbp, bo
     return pathLoss;
 }
 
+double LteRealisticChannelModel::getPathLoss(const Coord& coord, double distance, double dbp, bool los)
+{
+    if (usePathLossMap_)
+    {
+        // the map belongs to the base station, which is either the owner of this channel model or the other end point
+        const PathLossMap* map = nullptr;
+        const Coord* ueCoord = &coord;
+        if (phy_->getMacNodeId() <= ENB_MAX_ID)
+        {
+            if (!pathLossMapInitialized_)
+                initPathLossMap();
+
+            // the map is only valid while the base station stays where it was when the map was built
+            if (phy_->getCoord() == pathLossMapOrigin_)
+                map = binder_->findPathLossMap(pathLossMapOrigin_, carrierFrequency_);
+        }
+        else
+        {
+            map = getServingPathLossMap(coord);
+            ueCoord = &phy_->getCoord();
+        }
+
+        double pathLoss;
+        if (map != nullptr && map->getPathLoss(ueCoord->x, ueCoord->y, los, pathLoss))
+            return pathLoss;
+    }
+    return computePathLoss(distance, dbp, los);
+}
+
+const PathLossMap* LteRealisticChannelModel::getServingPathLossMap(const Coord& bsCoord)
+{
+    // base stations are static, hence their maps are identified by their position
+    const PathLossMap* map = binder_->findPathLossMap(bsCoord, carrierFrequency_);
+    if (map != nullptr)
+        return map;
+
+    // the map of the serving base station might not have been loaded or generated yet
+    MacNodeId masterId = check_and_cast<LtePhyUe*>(phy_)->getMasterId();
+    cModule* bsPhy = (masterId > 0) ? getPhyByMacNodeId(masterId) : nullptr;
+    if (bsPhy == nullptr)
+        return nullptr;
+    LteRealisticChannelModel* bsChannelModel = dynamic_cast<LteRealisticChannelModel*>(check_and_cast<LtePhyBase*>(bsPhy)->getChannelModel(carrierFrequency_));
+    if (bsChannelModel == nullptr || !bsChannelModel->usePathLossMap_ || bsChannelModel->pathLossMapInitialized_)
+        return nullptr;
+
+    bsChannelModel->initPathLossMap();
+    return binder_->findPathLossMap(bsCoord, carrierFrequency_);
+}
+
+double LteRealisticChannelModel::computePathLossAt(const Coord& bsCoord, const Coord& coord, bool los)
+{
+    return computePathLoss(bsCoord.distance(coord), 0, los);
+}
+
+void LteRealisticChannelModel::initPathLossMap()
+{
+    pathLossMapInitialized_ = true;
+
+    // the map is owned by the base station and shared with the channel models of the
+    // UEs through the binder
+    if (phy_->getMacNodeId() > ENB_MAX_ID)
+        return;
+
+    pathLossMapOrigin_ = phy_->getCoord();
+    PathLossMap& map = binder_->getPathLossMap(pathLossMapOrigin_, carrierFrequency_);
+    if (!map.empty())
+        return;
+
+    if (!pathLossMapFile_.empty())
+    {
+        map.load(pathLossMapFile_.c_str());
+        EV << "LteRealisticChannelModel::initPathLossMap - loaded path-loss map " << pathLossMapFile_ << endl;
+        return;
+    }
+
+    if (!isPathLossDeterministic())
+        throw cRuntimeError("LteRealisticChannelModel::initPathLossMap - the path loss model in use cannot be precomputed, please provide a path-loss map file");
+
+    // generate the map on a square centered on the base station. Receivers are assumed to lie on the ground (z=0)
+    unsigned int numPoints = 2 * (unsigned int)ceil(pathLossMapRange_ / pathLossMapResolution_) + 1;
+    double origin = -pathLossMapResolution_ * (numPoints / 2);
+    map.init(pathLossMapOrigin_.x + origin, pathLossMapOrigin_.y + origin, pathLossMapResolution_, numPoints, numPoints);
+
+    unsigned int invalidPoints = 0;
+    Coord point;
+    for (unsigned int y = 0; y < numPoints; y++)
+    {
+        point.y = map.getPointY(y);
+        for (unsigned int x = 0; x < numPoints; x++)
+        {
+            point.x = map.getPointX(x);
+            for (int los = 0; los < 2; los++)
+            {
+                // points outside the validity range of the model are left unavailable, so that
+                // the analytic model (and its error checks) is used there
+                try
+                {
+                    double pathLoss = computePathLossAt(pathLossMapOrigin_, point, los);
+                    if (pathLoss != ATT_MAXDISTVIOLATED)
+                        map.setValue(x, y, los, pathLoss);
+                    else
+                        invalidPoints++;
+                }
+                catch (cRuntimeError& e)
+                {
+                    if (invalidPoints == 0)
+                        EV << "LteRealisticChannelModel::initPathLossMap - point " << point << " (los=" << los << ") left unavailable: " << e.what() << endl;
+                    invalidPoints++;
+                }
+            }
+        }
+    }
+    EV << "LteRealisticChannelModel::initPathLossMap - generated path-loss map with " << numPoints << "x" << numPoints << " points, "
+       << invalidPoints << " values outside the validity range of the model" << endl;
+
+    if (!pathLossMapOutputFile_.empty())
+        map.save(pathLossMapOutputFile_.c_str());
+}
+
 double LteRealisticChannelModel::computeIndoor(double d, bool los)
 {
    double a, b;
@@ -2514,20 +3062,20 @@ double LteRealisticChannelModel::getStdDev(bool dist, MacNodeId nodeId)
    {
    case URBAN_MICROCELL:
    case INDOOR_HOTSPOT:
-       if (losMap_[nodeId])
+       if (getLos(nodeId))
            return 3.;
        else
            return 4.;
        break;
    case URBAN_MACROCELL:
-       if (losMap_[nodeId])
+       if (getLos(nodeId))
            return 4.;
        else
            return 6.;
        break;
    case RURAL_MACROCELL:
    case SUBURBAN_MACROCELL:
-       if (losMap_[nodeId])
+       if (getLos(nodeId))
        {
            if (dist)
                return 4.;
@@ -2548,9 +3096,13 @@ bool LteRealisticChannelModel::computeExtCellInterference(MacNodeId eNbId, MacNo
 {
    EV << "**** Ext Cell Interference **** " << endl;
 
+   // the coupling gains cannot be cached if the path loss model draws random numbers
+   if (enableExtCellInterferenceCache_ && isPathLossDeterministic())
+       return getCachedExtCellInterference(nodeId, coord, isCqi, carrierFrequency, interference);
+
    // get external cell list
-   ExtCellList list = binder_->getExtCellList(carrierFrequency);
-   ExtCellList::iterator it = list.begin();
+   const ExtCellList& list = binder_->getExtCellList(carrierFrequency);
+   ExtCellList::const_iterator it = list.begin();
 
    Coord c;
    double dist, // meters
@@ -2630,6 +3182,83 @@ bool LteRealisticChannelModel::computeExtCellInterference(MacNodeId eNbId, MacNo
    return true;
 }
 
+double LteRealisticChannelModel::computeExtCellCouplingGain(ExtCell* extCell, const Coord& coord, bool los)
+{
+   Coord c = extCell->getPosition();
+
+   // path loss, without the shadowing of the UE
+   double att = computePathLossAt(c, coord, los);
+
+   double angolarAtt = 0;
+   if (extCell->getTxDirection() != OMNI)
+   {
+       // compute the reception angle between ue and eNb
+       double recvAngle = fabs(extCell->getTxAngle() - computeAngle(c, coord));
+       if (recvAngle > 180)
+           recvAngle = 360 - recvAngle;
+
+       angolarAtt = computeAngolarAttenuation(recvAngle, computeVerticalAngle(c, coord));
+   }
+
+   return dBmToLinear(extCell->getTxPower() - att - angolarAtt - cableLoss_ + antennaGainEnB_ + antennaGainUe_);
+}
+
+bool LteRealisticChannelModel::getCachedExtCellInterference(MacNodeId nodeId, const Coord& coord, bool isCqi, double carrierFrequency,
+       std::vector<double>* interference)
+{
+   const ExtCellList& list = binder_->getExtCellList(carrierFrequency);
+   if (list.empty())
+       return true;
+
+   bool los = (enable_extCell_los_) ? getLos(nodeId) : false;
+
+   // the sum of the allocation versions changes whenever any ext cell changes its allocation
+   unsigned long version = 0;
+   for (ExtCellList::const_iterator it = list.begin(); it != list.end(); ++it)
+       version += (*it)->getAllocationVersion();
+
+   int gx = (int)floor(coord.x / extCellCacheGridSize_);
+   int gy = (int)floor(coord.y / extCellCacheGridSize_);
+   ExtCellCacheEntry& entry = extCellCache_[std::make_pair(std::make_pair(gx, gy), los)];
+
+   // coupling gains are computed once per grid cell, at its center
+   if (entry.couplingGain.size() != list.size())
+   {
+       Coord center((gx + 0.5) * extCellCacheGridSize_, (gy + 0.5) * extCellCacheGridSize_, coord.z);
+       entry.couplingGain.resize(list.size());
+       for (unsigned int k = 0; k < list.size(); k++)
+           entry.couplingGain[k] = computeExtCellCouplingGain(list[k], center, los);
+       entry.valid[0] = entry.valid[1] = false;
+   }
+
+   // aggregate the interference, if the allocation of some ext cells changed since the last computation
+   int t = (isCqi) ? 1 : 0;
+   if (!entry.valid[t] || entry.version[t] != version)
+   {
+       entry.interference[t].assign(numBands_, 0.0);
+       for (unsigned int k = 0; k < list.size(); k++)
+       {
+           ExtCell* extCell = list[k];
+           unsigned int numBands = std::min(numBands_, extCell->getNumBands());
+           for (unsigned int i = 0; i < numBands; i++)
+           {
+               int occ = (isCqi) ? extCell->getBandStatus(i) : extCell->getPrevBandStatus(i);
+               if (occ)
+                   entry.interference[t][i] += entry.couplingGain[k];
+           }
+       }
+       entry.version[t] = version;
+       entry.valid[t] = true;
+   }
+
+   double factor = getExtCellShadowingFactor(nodeId);
+   for (unsigned int i = 0; i < numBands_; i++)
+       (*interference)[i] += entry.interference[t][i] * factor;
+
+   EV << "LteRealisticChannelModel::getCachedExtCellInterference - grid cell (" << gx << "," << gy << ") los " << los << endl;
+   return true;
+}
+
 bool LteRealisticChannelModel::computeBackgroundCellInterference(MacNodeId nodeId, inet::Coord bsCoord, inet::Coord ueCoord, bool isCqi, double carrierFrequency, const RbMap& rbmap, Direction dir,
        std::vector<double>* interference)
 {
@@ -2789,7 +3418,7 @@ double LteRealisticChannelModel::computeExtCellPathLoss(double dist, MacNodeId n
    //    EV << "LteRealisticChannelModel::computeExtCellPathLoss:" << scenario_ << "-" << shadowing_ << "\n";
 
    //compute attenuation based on selected scenario and based on LOS or NLOS
-   bool los = losMap_[nodeId];
+   bool los = getLos(nodeId);
 
    if(!enable_extCell_los_)
       los = false;
@@ -2843,61 +3472,18 @@ double LteRealisticChannelModel::computeExtCellPathLoss(double dist, MacNodeId n
    return attenuation;
 }
 
-LteRealisticChannelModel::JakesFadingMap * LteRealisticChannelModel::obtainUeJakesMap(MacNodeId id)
+LteRealisticChannelModel* LteRealisticChannelModel::obtainUeChannelModel(MacNodeId id)
 {
-    // obtain a reference to UE phy
-    LtePhyBase * phy = nullptr;
-
-    std::vector<UeInfo*>* ueList = binder_->getUeList();
-    std::vector<UeInfo*>::iterator it;
-    for (it = ueList->begin(); it != ueList->end(); ++it)
-    {
-       UeInfo* ueInfo = *it;
-       if (ueInfo->id == id)
-       {
-           phy = ueInfo->phy;
-           break;
-       }
-    }
-
-    if (phy == nullptr)
-        return nullptr;
-
-    // get the associated channel and get a reference to its Jakes Map
-    JakesFadingMap *j;
-    LteRealisticChannelModel * re = dynamic_cast<LteRealisticChannelModel *>(phy->getChannelModel(carrierFrequency_));
-    if (re == NULL)
-        throw cRuntimeError("LteRealisticChannelModel::obtainUeJakesMap - channel model is a null pointer. Abort.");
-    else
-        j = re->getJakesMap();
-
-    return j;
+    // obtain a reference to the channel model of the UE on this carrier
+    return binder_->getUeChannelModel(id, carrierFrequency_);
 }
 
-LteRealisticChannelModel::ShadowFadingMap* LteRealisticChannelModel::obtainShadowingMap(MacNodeId id)
+LteRealisticChannelModel::NodeChannelState* LteRealisticChannelModel::obtainUeNodeState(MacNodeId id)
 {
-    // obtain a reference to UE phy
-    LtePhyBase * phy = nullptr;
-
-    std::vector<UeInfo*>* ueList = binder_->getUeList();
-    std::vector<UeInfo*>::iterator it;
-    for (it = ueList->begin(); it != ueList->end(); ++it)
-    {
-       UeInfo* ueInfo = *it;
-       if (ueInfo->id == id)
-       {
-           phy = ueInfo->phy;
-           break;
-       }
-    }
-
-    if (phy == nullptr)
+    LteRealisticChannelModel* re = obtainUeChannelModel(id);
+    if (re == nullptr)
         return nullptr;
-
-    // get the associated channel and get a reference to its shadowing Map
-    LteRealisticChannelModel * re = dynamic_cast<LteRealisticChannelModel *>(phy->getChannelModel(carrierFrequency_));
-    ShadowFadingMap* j = re->getShadowingMap();
-    return j;
+    return &(re->getNodeState(id));
 }
 
 
@@ -2906,14 +3492,25 @@ bool LteRealisticChannelModel::computeDownlinkInterference(MacNodeId eNbId, MacN
 {
    EV << "**** Downlink Interference ****" << endl;
 
-   // reference to the mac/phy/channel of each cell
+   prepareDownlinkInterferers(eNbId, &coord, isCqi, carrierFrequency, dlInterferers_);
+   addDownlinkInterference(ueId, coord, isCqi, rbmap, dlInterferers_, interference);
 
-   int temp;
-   double att;
+   return true;
+}
 
-   double txPwr;
+void LteRealisticChannelModel::prepareDownlinkInterferers(MacNodeId eNbId, const Coord* coord, bool isCqi, double carrierFrequency,
+       std::vector<DlInterferer>& interferers)
+{
+   interferers.clear();
 
+   // reference to the mac/phy/channel of each cell
    std::vector<EnbInfo*> * enbList = binder_->getEnbList();
+   if (downlinkInterferenceCutoffDistance_ > 0 && coord != nullptr)
+   {
+       // only consider the cells located within the cutoff distance from the UE
+       binder_->getEnbsInRange(carrierFrequency, *coord, downlinkInterferenceCutoffDistance_, interferingEnbs_);
+       enbList = &interferingEnbs_;
+   }
    std::vector<EnbInfo*>::iterator it = enbList->begin(), et = enbList->end();
 
    while(it!=et)
@@ -2955,16 +3552,57 @@ bool LteRealisticChannelModel::computeDownlinkInterference(MacNodeId eNbId, MacN
            continue;
        }
 
+       DlInterferer interferer;
+       interferer.info = *it;
+       interferer.chanModel = interfChanModel;
+       interferer.numBands = std::min(numBands_, interfChanModel->getNumBands());
+
+       // store the slot occupation in this TTI (CQI) or in the previous one (error computation)
+       interferer.occupiedBands.resize(interferer.numBands);
+       for (unsigned int i = 0; i < interferer.numBands; i++)
+           interferer.occupiedBands[i] = (isCqi) ? (*it)->mac->getDlBandStatus(i) : (*it)->mac->getDlPrevBandStatus(i);
+
+       interferers.push_back(interferer);
+       ++it;
+   }
+}
+
+void LteRealisticChannelModel::addDownlinkInterference(MacNodeId ueId, const Coord& coord, bool isCqi, const RbMap& rbmap,
+       const std::vector<DlInterferer>& interferers, std::vector<double> * interference)
+{
+   int temp;
+   double att;
+
+   double txPwr;
+
+   std::vector<DlInterferer>::const_iterator it = interferers.begin(), et = interferers.end();
+   for (; it != et; ++it)
+   {
+       EnbInfo* enbInfo = it->info;
+       MacNodeId id = enbInfo->id;
+       LteRealisticChannelModel* interfChanModel = it->chanModel;
+
+       // interferers shared by several UEs are not filtered by distance in advance
+       if (downlinkInterferenceCutoffDistance_ > 0 && coord.distance(interfChanModel->phy_->getCoord()) > downlinkInterferenceCutoffDistance_)
+           continue;
+
        // compute attenuation using data structures within the cell
-       att = interfChanModel->getAttenuation(ueId,UL,coord,isCqi);
+       att = interfChanModel->getInterferenceAttenuation(ueId,coord,isCqi);
        EV << "EnbId [" << id << "] - attenuation [" << att << "]";
 
        //=============== ANGOLAR ATTENUATION =================
        double angolarAtt = 0;
-       if ((*it)->txDirection == ANISOTROPIC)
+       // the link budget has been stored with the shadowing mode used for interfering links
+       LteRealisticChannelModel::LinkBudget* linkBudget = (interfChanModel->enableLinkBudgetCache_) ?
+               interfChanModel->getCachedLinkBudget(ueId, isCqi, coord, interfChanModel->meanInterferencePower_) : nullptr;
+       if (linkBudget != nullptr && linkBudget->angolarAttValid)
+       {
+           angolarAtt = linkBudget->angolarAtt;
+       }
+       else if (enbInfo->txDirection == ANISOTROPIC)
        {
            //get tx angle
-           double txAngle = (*it)->txAngle;
+           double txAngle = enbInfo->txAngle;
 
            // compute the angle between uePosition and reference axis, considering the eNb as center
            double ueAngle = computeAngle(interfChanModel->phy_->getCoord(), coord);
@@ -2982,46 +3620,44 @@ bool LteRealisticChannelModel::computeDownlinkInterference(MacNodeId eNbId, MacN
            EV << "angolar attenuation [" << angolarAtt << "]";
        }
        // else, antenna is omni-directional
-       //=============== END ANGOLAR ATTENUATION =================
 
-       txPwr = (*it)->txPwr - angolarAtt - cableLoss_ + antennaGainEnB_ + antennaGainUe_;
+       if (linkBudget != nullptr)
+       {
+           linkBudget->angolarAtt = angolarAtt;
+           linkBudget->angolarAttValid = true;
+       }
+       //=============== END ANGOLAR ATTENUATION =================
 
-       unsigned int numBands = std::min(numBands_, interfChanModel->getNumBands());
-       EV << " - shared bands [" << numBands << "]" << endl;
+       txPwr = enbInfo->txPwr - angolarAtt - cableLoss_ + antennaGainEnB_ + antennaGainUe_;
 
-       if(isCqi)// check slot occupation for this TTI
+       // neglect contributions below the interference threshold
+       if (txPwr - att < downlinkInterferenceThreshold_)
        {
-           for(unsigned int i=0;i<numBands;i++)
-           {
-               // compute the number of occupied slot (unnecessary)
-               temp = (*it)->mac->getDlBandStatus(i);
-               if(temp!=0)
-                   (*interference)[i] += dBmToLinear(txPwr-att);//(dBm-dB)=dBm
-
-               EV << "\t band " << i << " occupied " << temp << "/pwr[" << txPwr << "]-int[" << (*interference)[i] << "]" << endl;
-           }
+           EV << " - below the interference threshold, skipped" << endl;
+           continue;
        }
-       else // error computation. We need to check the slot occupation of the previous TTI
+
+       // the received power is the same on all the bands, hence it is linearized only once
+       double recvPwr = dBmToLinear(txPwr-att);//(dBm-dB)=dBm
+
+       unsigned int numBands = it->numBands;
+       EV << " - shared bands [" << numBands << "]" << endl;
+
+       for(unsigned int i=0;i<numBands;i++)
        {
-           for(unsigned int i=0;i<numBands;i++)
-           {
-               // if we are decoding a data transmission and this RB has not been used, skip it
-               // TODO fix for multi-antenna case
-               if (!rbmap.empty() && rbmap.at(MACRO).at(i) == 0)
-                   continue;
+           // if we are decoding a data transmission and this RB has not been used, skip it
+           // TODO fix for multi-antenna case
+           if (!isCqi && !rbmap.empty() && rbmap.at(MACRO).at(i) == 0)
+               continue;
 
-               // compute the number of occupied slot (unnecessary)
-               temp = (*it)->mac->getDlPrevBandStatus(i);
-               if(temp!=0)
-                   (*interference)[i] += dBmToLinear(txPwr-att);//(dBm-dB)=dBm
+           // compute the number of occupied slot (unnecessary)
+           temp = it->occupiedBands[i];
+           if(temp!=0)
+               (*interference)[i] += recvPwr;
 
-               EV << "\t band " << i << " occupied " << temp << "/pwr[" << txPwr << "]-int[" << (*interference)[i] << "]" << endl;
-           }
+           EV << "\t band " << i << " occupied " << temp << "/pwr[" << txPwr << "]-int[" << (*interference)[i] << "]" << endl;
        }
-       ++it;
    }
-
-   return true;
 }
 
 bool LteRealisticChannelModel::computeUplinkInterference(MacNodeId eNbId, MacNodeId senderId, bool isCqi, double carrierFrequency, const RbMap& rbmap, std::vector<double> * interference)
@@ -3032,7 +3668,26 @@ bool LteRealisticChannelModel::computeUplinkInterference(MacNodeId eNbId, MacNod
    const std::vector<UeAllocationInfo>* allocatedUes;
    std::vector<UeAllocationInfo>::const_iterator ue_it, ue_et;
 
-   if(isCqi)// check slot occupation for this TTI
+   // use the interference aggregated over all the interfering UEs, if available.
+   // This is possible only when the interference is evaluated at the receiving cell
+   const UlInterferenceInfo* aggregatedInterference = nullptr;
+   if (aggregateUplinkInterference_ && phy_->getMacNodeId() == eNbId)
+       aggregatedInterference = obtainAggregatedUplinkInterference(eNbId, carrierFrequency, (isCqi) ? CURR_TTI : PREV_TTI);
+
+   // the sender itself cannot interfere with its own transmission, so fall back to per-UE evaluation if needed
+   if (aggregatedInterference != nullptr && aggregatedInterference->interferers.find(senderId) == aggregatedInterference->interferers.end())
+   {
+       unsigned int numBands = std::min(numBands_, (unsigned int)aggregatedInterference->power.size());
+       for (unsigned int i = 0; i < numBands; i++)
+       {
+           // if we are decoding a data transmission and this RB has not been used, skip it
+           if (!isCqi && !rbmap.empty() && rbmap.at(MACRO).at(i) == 0)
+               continue;
+
+           (*interference)[i] += aggregatedInterference->power[i];
+       }
+   }
+   else if(isCqi)// check slot occupation for this TTI
    {
        ulTransmissionMap = binder_->getUlTransmissionMap(carrierFrequency, CURR_TTI);
        if (ulTransmissionMap != nullptr && !ulTransmissionMap->empty())
@@ -3077,7 +3732,7 @@ bool LteRealisticChannelModel::computeUplinkInterference(MacNodeId eNbId, MacNod
 
                    // get rx power and attenuation from this UE
                    double rxPwr = txPwr - cableLoss_ + antennaGainUe_ + antennaGainEnB_;
-                   double att = getAttenuation(ueId, UL, ueCoord, false);
+                   double att = getInterferenceAttenuation(ueId, ueCoord, false);
                    (*interference)[i] += dBmToLinear(rxPwr-att);//(dBm-dB)=dBm
 
                    EV << "\t band " << i << "/pwr[" << rxPwr-att << "]-int[" << (*interference)[i] << "]" << endl;
@@ -3136,7 +3791,7 @@ bool LteRealisticChannelModel::computeUplinkInterference(MacNodeId eNbId, MacNod
 
                    // get tx power and attenuation from this UE
                    double rxPwr = txPwr - cableLoss_ + antennaGainUe_ + antennaGainEnB_;
-                   double att = getAttenuation(ueId, UL, ueCoord, false);
+                   double att = getInterferenceAttenuation(ueId, ueCoord, false);
                    (*interference)[i] += dBmToLinear(rxPwr-att);//(dBm-dB)=dBm
 
                    EV << "\t band " << i << "/pwr[" << rxPwr-att << "]-int[" << (*interference)[i] << "]" << endl;
@@ -3153,6 +3808,68 @@ bool LteRealisticChannelModel::computeUplinkInterference(MacNodeId eNbId, MacNod
    return true;
 }
 
+const UlInterferenceInfo* LteRealisticChannelModel::obtainAggregatedUplinkInterference(MacCellId eNbId, double carrierFrequency, UlTransmissionMapTTI t)
+{
+   const UlInterferenceInfo* info = binder_->getUlInterferenceInfo(carrierFrequency, t, eNbId);
+   if (info != nullptr)
+       return info;
+
+   EV << NOW << " LteRealisticChannelModel::obtainAggregatedUplinkInterference - computing the UL interference for cellId[" << eNbId << "]" << endl;
+
+   std::vector<double> power(numBands_, 0.0);
+   std::set<MacNodeId> interferers;
+
+   // the received power from each UE is the same on all the bands
+   std::map<std::pair<MacNodeId, Direction>, double> rxPwrMap;
+
+   const std::vector<std::vector<UeAllocationInfo> >* ulTransmissionMap = binder_->getUlTransmissionMap(carrierFrequency, t);
+   if (ulTransmissionMap != nullptr && !ulTransmissionMap->empty())
+   {
+       for (unsigned int i = 0; i < numBands_; i++)
+       {
+           // get the set of UEs transmitting on the same band
+           const std::vector<UeAllocationInfo>& allocatedUes = ulTransmissionMap->at(i);
+           std::vector<UeAllocationInfo>::const_iterator ue_it = allocatedUes.begin(), ue_et = allocatedUes.end();
+           for (; ue_it != ue_et; ++ue_it)
+           {
+               // no interference from UL/D2D connections of the same cell  (no D2D-UL reuse allowed)
+               if (ue_it->cellId == eNbId)
+                   continue;
+
+               std::pair<MacNodeId, Direction> key(ue_it->nodeId, ue_it->dir);
+               std::map<std::pair<MacNodeId, Direction>, double>::iterator pit = rxPwrMap.find(key);
+               if (pit == rxPwrMap.end())
+               {
+                   double txPwr;
+                   inet::Coord ueCoord;
+                   if (ue_it->phy != nullptr)
+                   {
+                       LtePhyUe* uePhy = check_and_cast<LtePhyUe*>(ue_it->phy);
+                       txPwr = uePhy->getTxPwr(ue_it->dir);
+                       ueCoord = uePhy->getCoord();
+                   }
+                   else  // this is a backgroundUe
+                   {
+                       TrafficGeneratorBase* trafficGen = check_and_cast<TrafficGeneratorBase*>(ue_it->trafficGen);
+                       txPwr = trafficGen->getTxPwr();
+                       ueCoord = trafficGen->getCoord();
+                   }
+
+                   // get rx power and attenuation from this UE
+                   double rxPwr = txPwr - cableLoss_ + antennaGainUe_ + antennaGainEnB_;
+                   double att = getInterferenceAttenuation(ue_it->nodeId, ueCoord, false);
+                   pit = rxPwrMap.insert(std::make_pair(key, dBmToLinear(rxPwr-att))).first;
+               }
+
+               power[i] += pit->second;
+               interferers.insert(ue_it->nodeId);
+           }
+       }
+   }
+
+   return binder_->storeUlInterferenceInfo(carrierFrequency, t, eNbId, power, interferers);
+}
+
 bool LteRealisticChannelModel::computeD2DInterference(MacNodeId eNbId, MacNodeId senderId, Coord senderCoord, MacNodeId destId, Coord destCoord, bool isCqi, double carrierFrequency, const RbMap& rbmap,
    std::vector<double> * interference,Direction dir)
 {
@@ -3214,7 +3931,7 @@ bool LteRealisticChannelModel::computeD2DInterference(MacNodeId eNbId, MacNodeId
 
                    // get tx power and attenuation from this UE
                    double rxPwr = txPwr - cableLoss_ + 2 * antennaGainUe_;
-                   double att = getAttenuation_D2D(ueId, D2D, ueCoord, destId, destCoord, false);
+                   double att = getInterferenceAttenuation_D2D(ueId, ueCoord, destId, destCoord);
                    (*interference)[i] += dBmToLinear(rxPwr-att);//(dBm-dB)=dBm
 
                    EV << "\t band " << i << "/pwr[" << rxPwr-att << "]-int[" << (*interference)[i] << "]" << endl;
@@ -3272,7 +3989,7 @@ bool LteRealisticChannelModel::computeD2DInterference(MacNodeId eNbId, MacNodeId
 
                    // get tx power and attenuation from this UE
                    double rxPwr = txPwr - cableLoss_ + 2 * antennaGainUe_;
-                   double att = getAttenuation_D2D(ueId, D2D, ueCoord, destId, destCoord, false);
+                   double att = getInterferenceAttenuation_D2D(ueId, ueCoord, destId, destCoord);
                    (*interference)[i] += dBmToLinear(rxPwr-att);//(dBm-dB)=dBm
 
                    EV << "\t band " << i << "/pwr[" << rxPwr-att << "]-int[" << (*interference)[i] << "]" << endl;
@@ -3288,3 +4005,35 @@ bool LteRealisticChannelModel::computeD2DInterference(MacNodeId eNbId, MacNodeId
 
    return true;
 }
+
+LteRealisticChannelModel::LinkBudget* LteRealisticChannelModel::getCachedLinkBudget(MacNodeId nodeId, bool cqiDl, const Coord& coord, bool meanAttenuation)
+{
+    LinkBudgetCache::iterator it = linkBudgetCache_.find(LinkBudgetKey(nodeId, std::make_pair(cqiDl, meanAttenuation)));
+    if (it == linkBudgetCache_.end())
+        return nullptr;
+
+    // the entry is valid within the same TTI only, and as long as none of the end points has moved
+    LinkBudget& linkBudget = it->second;
+    if (linkBudget.time != NOW || linkBudget.coord != coord || linkBudget.myCoord != phy_->getCoord())
+        return nullptr;
+
+    return &linkBudget;
+}
+
+void LteRealisticChannelModel::storeLinkBudget(MacNodeId nodeId, bool cqiDl, const Coord& coord, bool meanAttenuation, double attenuation)
+{
+    LinkBudget& linkBudget = linkBudgetCache_[LinkBudgetKey(nodeId, std::make_pair(cqiDl, meanAttenuation))];
+    linkBudget.time = NOW;
+    linkBudget.coord = coord;
+    linkBudget.myCoord = phy_->getCoord();
+    linkBudget.attenuation = attenuation;
+    linkBudget.angolarAttValid = false;
+    linkBudget.angolarAtt = 0.0;
+}
+
+void LteRealisticChannelModel::invalidateLinkBudget(MacNodeId nodeId)
+{
+    // LinkBudgetKey is ordered by node first, hence all the entries of the node are contiguous
+    linkBudgetCache_.erase(linkBudgetCache_.lower_bound(LinkBudgetKey(nodeId, std::make_pair(false, false))),
+                           linkBudgetCache_.upper_bound(LinkBudgetKey(nodeId, std::make_pair(true, true))));
+}
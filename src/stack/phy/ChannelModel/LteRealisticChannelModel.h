@@ -13,7 +13,9 @@
 #define STACK_PHY_CHANNELMODEL_LTEREALISTICCHANNELMODEL_H_
 
 #include <omnetpp.h>
+#include <deque>
 #include "stack/phy/ChannelModel/LteChannelModel.h"
+#include "stack/phy/ChannelModel/PathLossMap.h"
 
 class Binder;
 
@@ -60,23 +62,9 @@ protected:
 
   typedef std::pair<inet::simtime_t, inet::Coord> Position;
 
-  // last position of current user
-  std::map<MacNodeId, std::queue<Position> > positionHistory_;
-
-  // last position of current user at which probability of LOS
-  // was computed.
-  std::map<MacNodeId, Position> lastCorrelationPoint_;
-
   // scenario
   DeploymentScenario scenario_;
 
-  // map that stores for each user if is in Line of Sight or not with eNodeB
-  std::map<MacNodeId, bool> losMap_;
-
-  // Store the last computed shadowing for each user
-  typedef std::map<MacNodeId, std::pair<inet::simtime_t, double> > ShadowFadingMap;
-  ShadowFadingMap lastComputedSF_;
-
   //correlation distance used in shadowing computation and
   //also used to recompute the probability of LOS
   double correlationDistance_;
@@ -125,20 +113,176 @@ protected:
 
   bool tolerateMaxDistViolation_;
 
-  //Struct used to store information about jakes fading
+  // interfering cells farther than this distance from the UE are neglected in DL (disabled if not positive)
+  double downlinkInterferenceCutoffDistance_;
+  // DL interference contributions below this threshold (dBm) are neglected
+  double downlinkInterferenceThreshold_;
+  // scratch vector storing the cells located within the cutoff distance
+  std::vector<EnbInfo*> interferingEnbs_;
+
+  // information about a cell interfering in DL
+  struct DlInterferer
+  {
+      EnbInfo* info;
+      LteRealisticChannelModel* chanModel;
+      // number of bands shared with the serving cell
+      unsigned int numBands;
+      // slot occupation of each band
+      std::vector<unsigned int> occupiedBands;
+  };
+  // scratch vector storing the cells interfering in DL
+  std::vector<DlInterferer> dlInterferers_;
+  // cells interfering in DL shared by the UEs of a batch, see getSINRBatch()
+  std::vector<DlInterferer> feedbackBatchInterferers_;
+
+  // if true, the UL interference perceived by a cell is aggregated over all the interfering UEs once per TTI
+  bool aggregateUplinkInterference_;
+
+  // if true, the Jakes fading of a node is computed once per TTI for all the bands
+  bool memoizeFading_;
+
+  /*
+   * Struct used to store information about jakes fading of one node.
+   * Data are stored as flat arrays, path-major (i.e. element [path * numBands + band]),
+   * so that the fading for all the bands can be computed in a single pass
+   */
   struct JakesFadingData
   {
+      unsigned int numBands;
+      // cosine of the angle of arrival of each path
       std::vector<double> angleOfArrival;
-      std::vector<omnetpp::simtime_t> delaySpread;
+      // phase shift due to the delay spread of each path (delay * carrier frequency)
+      std::vector<double> delayPhase;
+
+      // fading computed for all the bands at the last update
+      omnetpp::simtime_t lastTime;
+      double lastSpeed;
+      std::vector<double> lastFading;
   };
 
-  // for each node and for each band we store information about jakes fading
-  std::map<MacNodeId, std::vector<JakesFadingData> > jakesFadingMap_;
-  // for each node and for each band we store information about jakes fading
-  std::map<MacNodeId, std::vector<JakesFadingData> > jakesFadingMapBgUe_;
+  typedef std::map<MacNodeId, JakesFadingData> JakesFadingMap;
+
+  // for each node we store information about jakes fading
+  JakesFadingMap jakesFadingMap_;
+  // for each node we store information about jakes fading
+  JakesFadingMap jakesFadingMapBgUe_;
+
+  /*
+   * Channel state of one node, as seen by this channel model
+   */
+  struct NodeChannelState
+  {
+      // last two positions of the node (ring buffer, the newest is positions[lastPosition])
+      Position positions[2];
+      unsigned char numPositions;
+      unsigned char lastPosition;
 
-  typedef std::vector<JakesFadingData> JakesFadingVector;
-  typedef std::map<MacNodeId, JakesFadingVector> JakesFadingMap;
+      // last position of the node at which the probability of LOS was computed
+      bool hasCorrelationPoint;
+      Position correlationPoint;
+
+      // whether the node is in Line of Sight with the eNodeB
+      bool hasLos;
+      bool los;
+
+      // last computed shadowing and its temporal mark
+      bool hasShadowing;
+      inet::simtime_t shadowingTime;
+      double shadowing;
+
+      // jakes fading data of the node within jakesFadingMap_ (nullptr if not created yet)
+      JakesFadingData* jakesFading;
+
+      NodeChannelState() : numPositions(0), lastPosition(0), hasCorrelationPoint(false), hasLos(false), los(false),
+          hasShadowing(false), shadowing(0.0), jakesFading(nullptr) {}
+  };
+
+  // channel state of the nodes seen by this channel model. A deque is used so that references
+  // to the stored states remain valid when new nodes are added
+  std::deque<NodeChannelState> nodeState_;
+
+  // slot of each node within nodeState_, assigned on the first access to the node
+  std::map<MacNodeId, unsigned int> nodeSlot_;
+
+  // last accessed node and its state (consecutive accesses usually refer to the same node)
+  MacNodeId lastStateNodeId_ = 0;
+  NodeChannelState* lastState_ = nullptr;
+
+  NodeChannelState& getNodeState(MacNodeId nodeId)
+  {
+      if (lastState_ != nullptr && lastStateNodeId_ == nodeId)
+          return *lastState_;
+
+      std::map<MacNodeId, unsigned int>::iterator it = nodeSlot_.find(nodeId);
+      if (it == nodeSlot_.end())
+      {
+          it = nodeSlot_.insert(std::make_pair(nodeId, (unsigned int) nodeState_.size())).first;
+          nodeState_.emplace_back();
+      }
+      lastStateNodeId_ = nodeId;
+      lastState_ = &nodeState_[it->second];
+      return *lastState_;
+  }
+
+  void setLos(MacNodeId nodeId, bool los)
+  {
+      NodeChannelState& state = getNodeState(nodeId);
+      state.hasLos = true;
+      state.los = los;
+  }
+
+  // NOTE: the LOS state of a node is considered as computed after the first access
+  bool getLos(MacNodeId nodeId)
+  {
+      NodeChannelState& state = getNodeState(nodeId);
+      state.hasLos = true;
+      return state.los;
+  }
+
+  // scratch buffers used by computeJakesFading()
+  std::vector<double> jakesRe_;
+  std::vector<double> jakesIm_;
+  std::vector<double> jakesFadingBuffer_;
+  // fading attenuation for all the bands, filled by computeFading()
+  std::vector<double> fadingAttenuation_;
+
+  /*
+   * Parameters of the link evaluated by getSINR() and getMeanSINR()
+   */
+  struct SinrLinkInfo
+  {
+      MacNodeId ueId;
+      MacNodeId eNbId;
+      Direction dir;
+      // true if we are computing a CQI for the DL direction
+      bool cqiDl;
+      double speed;
+      double noiseFigure;
+      double antennaGainTx;
+      double antennaGainRx;
+      // attenuation for the desired signal (pathloss + shadowing)
+      double attenuation;
+      inet::Coord coord;
+      inet::Coord ueCoord;
+      inet::Coord enbCoord;
+  };
+  // scratch vectors storing the interference for each band, used by getMeanSINR()
+  std::vector<double> multiCellInterference_;
+  std::vector<double> bgCellInterference_;
+  std::vector<double> extCellInterference_;
+
+  /*
+   * Set up the parameters of the link and compute the power received from the serving node
+   * (including pathloss, shadowing, antenna gains and angolar attenuation, excluding fading)
+   *
+   * @return the received power in dBm
+   */
+  double computeServingPower(UserControlInfo* lteInfo, SinrLinkInfo& link);
+  /*
+   * Compute the interference (linear values) perceived on each band by the receiver of the link
+   */
+  void computeSinrInterference(UserControlInfo* lteInfo, const SinrLinkInfo& link, const RbMap& rbmap,
+          std::vector<double>& multiCellInterference, std::vector<double>& bgCellInterference, std::vector<double>& extCellInterference);
 
   enum FadingType
   {
@@ -157,6 +301,75 @@ protected:
   // if false, disable the collection of SINR statistics, which might be quite time-consuming
   bool collectSinrStatistics_;
 
+  // if true, the link budget computed for a node is reused for the rest of the TTI
+  bool enableLinkBudgetCache_;
+
+  //Struct used to store the link budget between the node owning this channel model and another node
+  struct LinkBudget
+  {
+      omnetpp::simtime_t time;  // TTI when the link budget has been computed
+      inet::Coord coord;        // position of the other end point
+      inet::Coord myCoord;      // position of the node owning this channel model
+      double attenuation;       // path loss + shadowing (dB)
+      bool angolarAttValid;     // true if the angular attenuation has been computed
+      double angolarAtt;        // attenuation due to sectorial tx (dB)
+  };
+
+  // for each node, for each shadowing map (i.e. cqiDl flag) and for each shadowing mode (i.e.
+  // per-link or mean shadowing) we store the link budget computed within the current TTI
+  typedef std::pair<MacNodeId, std::pair<bool, bool> > LinkBudgetKey;
+  typedef std::map<LinkBudgetKey, LinkBudget> LinkBudgetCache;
+  LinkBudgetCache linkBudgetCache_;
+  // number of getAttenuation() calls served by (hits) or missing (misses) the link budget cache
+  long linkBudgetCacheHits_;
+  long linkBudgetCacheMisses_;
+
+  // if true, the shadowing is read from a spatially correlated field generated for each base station
+  bool useShadowingMap_;
+  // resolution and half-size of the shadowing field
+  double shadowingMapResolution_;
+  double shadowingMapRange_;
+  // dedicated RNG used to generate the shadowing fields
+  omnetpp::cRNG* shadowingMapRng_;
+
+  // if true, interfering links contribute their mean received power, i.e. the per-link
+  // shadowing is not sampled (fast fading is never applied to interfering links)
+  bool meanInterferencePower_;
+  // if true, the mean received power of interfering links accounts for the log-normal shadowing
+  bool interferenceShadowingCorrection_;
+
+  // if true, the ext-cell interference is computed from coupling gains precomputed
+  // on a grid of UE positions with the given cell size
+  bool enableExtCellInterferenceCache_;
+  double extCellCacheGridSize_;
+
+  struct ExtCellCacheEntry
+  {
+      std::vector<double> couplingGain;     // linear received power from each ext cell
+      bool valid[2];                        // for the previous (0) and current (1) TTI allocation
+      unsigned long version[2];             // sum of the ext-cell allocation versions the interference refers to
+      std::vector<double> interference[2];  // per-band interference (linear)
+      ExtCellCacheEntry() { valid[0] = valid[1] = false; version[0] = version[1] = 0; }
+  };
+  // key is ((x,y) of the grid cell, los flag)
+  std::map<std::pair<std::pair<int,int>, bool>, ExtCellCacheEntry> extCellCache_;
+
+  // if true, the path loss between the base station and the UEs is read from a raster
+  // map instead of being computed by the analytic model. The map is owned by the channel
+  // model of the base station and shared with the UEs through the binder
+  bool usePathLossMap_;
+  // binary file to load the map from. If empty, the map is generated from the analytic model
+  std::string pathLossMapFile_;
+  // binary file where the generated map is stored (optional)
+  std::string pathLossMapOutputFile_;
+  // resolution and half-size of the generated map
+  double pathLossMapResolution_;
+  double pathLossMapRange_;
+  // true once the map has been loaded or generated
+  bool pathLossMapInitialized_;
+  // position of the base station when the map has been initialized
+  inet::Coord pathLossMapOrigin_;
+
   // statistics
   static omnetpp::simsignal_t rcvdSinrDl_;
   static omnetpp::simsignal_t rcvdSinrUl_;
@@ -173,6 +386,12 @@ protected:
 
 public:
   virtual void initialize(int stage);
+  virtual void finish();
+
+  /*
+   * Returns the distance beyond which cells are not considered as DL interferers (0 if disabled)
+   */
+  double getDownlinkInterferenceCutoffDistance() const { return downlinkInterferenceCutoffDistance_; }
 
   /*
    * Compute Attenuation caused by pathloss and shadowing (optional)
@@ -180,16 +399,18 @@ public:
    * @param nodeid mac node id of UE
    * @param dir traffic direction
    * @param coord position of end point comunication (if dir==UL is the position of UE else is the position of eNodeB)
+   * @param meanAttenuation if true, the per-link shadowing is replaced by its mean effect (see computeMeanShadowing())
    */
-  virtual double getAttenuation(MacNodeId nodeId, Direction dir, inet::Coord coord, bool cqiDl);
+  virtual double getAttenuation(MacNodeId nodeId, Direction dir, inet::Coord coord, bool cqiDl, bool meanAttenuation = false);
   /*
    * Compute Attenuation for D2D caused by pathloss and shadowing (optional)
    *
    * @param nodeid mac node id of UE
    * @param dir traffic direction
    * @param coord position of end point comunication (if dir==UL is the position of UE else is the position of eNodeB)
+   * @param meanAttenuation if true, the per-link shadowing is replaced by its mean effect (see computeMeanShadowing())
    */
-  virtual double getAttenuation_D2D(MacNodeId nodeId, Direction dir, inet::Coord coord,MacNodeId node2_Id, inet::Coord coord_2, bool cqiDl);
+  virtual double getAttenuation_D2D(MacNodeId nodeId, Direction dir, inet::Coord coord,MacNodeId node2_Id, inet::Coord coord_2, bool cqiDl, bool meanAttenuation = false);
   /*
    *  Compute angle between two coordinates
    *
@@ -221,6 +442,37 @@ public:
    * @param speed speed of UE
    */
   virtual double computeShadowing(double sqrDistance, MacNodeId nodeId, double speed, bool cqiDl);
+
+  /*
+   * Returns the correction (dB) to apply to the path loss to obtain the mean received power,
+   * averaged over the log-normal shadowing. Used for interfering links when meanInterferencePower is set
+   *
+   * @param nodeId mac node id of UE
+   */
+  double computeMeanShadowing(MacNodeId nodeId);
+
+  /*
+   * Returns the standard deviation (dB) of the shadowing for the given UE
+   */
+  virtual double getShadowingStdDev(MacNodeId nodeId);
+
+  /*
+   * Returns the shadowing (dB) read from the correlated shadowing field of the base station
+   * at the position of the UE. The field is generated at the first use, from the
+   * shadowingMapRng RNG, and shared by all the channel models through the Binder
+   *
+   * @param coord position of the other end point
+   * @param nodeId mac node id of UE
+   * @param cqiDl true if the value must be stored on the UE side
+   */
+  double computeShadowingFromMap(const inet::Coord& coord, MacNodeId nodeId, bool cqiDl);
+
+  /*
+   * Compute the attenuation of an interfering link. If meanInterferencePower is set,
+   * the per-link shadowing is replaced by its mean effect (see computeMeanShadowing())
+   */
+  double getInterferenceAttenuation(MacNodeId nodeId, inet::Coord coord, bool cqiDl);
+  double getInterferenceAttenuation_D2D(MacNodeId nodeId, inet::Coord coord, MacNodeId node2_Id, inet::Coord coord_2);
   /*
    * Compute sir for each band for user nodeId according to multipath fading
    *
@@ -235,6 +487,34 @@ public:
    * @param lteinfo pointer to the user control info
    */
   virtual std::vector<double> getSINR(LteAirFrame *frame, UserControlInfo* lteInfo);
+  /*
+   * Compute the DL sinr of a set of UEs served by the given cell, for the feedback they reported,
+   * with the same result as getSINR() (or getMeanSINR() for wideband reports). The interfering
+   * cells and their band occupation are evaluated once per call and shared by all the UEs
+   *
+   * @param cellId id of the serving cell
+   * @param ueIds ids of the UEs
+   * @param carrierFrequency carrier frequency
+   * @param reports control info of the feedback of each UE (position, tx power and mode, feedback type)
+   */
+  virtual std::vector<std::vector<double> > getSINRBatch(MacCellId cellId, const std::vector<MacNodeId>& ueIds, double carrierFrequency,
+          const std::vector<UserControlInfo*>& reports);
+  /*
+   * Compute the sinr averaged over all the bands, as getSINR() followed by the mean would do.
+   * For feedback packets without fading, the sinr is accumulated without building the per-band vectors
+   *
+   * @param frame pointer to the packet
+   * @param lteinfo pointer to the user control info
+   */
+  virtual double getMeanSINR(LteAirFrame *frame, UserControlInfo* lteInfo);
+  /*
+   * Compute a single wideband SNR value for the given DL frame, according to pathloss and shadowing (optional).
+   * Fading and interference are not considered
+   *
+   * @param frame pointer to the packet
+   * @param lteinfo pointer to the user control info
+   */
+  virtual double getWidebandSNR(LteAirFrame *frame, UserControlInfo* lteInfo);
   /*
    * Compute received useful signal for each band for user nodeId according to pathloss, shadowing (optional) and multipath fading
    *
@@ -303,6 +583,36 @@ public:
    * @param los line-of-sight flag
    */
   virtual double computePathLoss(double distance, double dbp, bool los);
+  /*
+   * Returns the path loss between the node owning this channel model and the given position.
+   * If the raster path-loss map is enabled and covers the position, the value is interpolated
+   * from the map, otherwise computePathLoss() is invoked with the given parameters
+   *
+   * @param coord position of the other end point
+   * @param distance, dbp parameters for computePathLoss()
+   * @param los line-of-sight flag
+   */
+  double getPathLoss(const inet::Coord& coord, double distance, double dbp, bool los);
+  /*
+   * Compute the path loss between two positions using the analytic model.
+   * Used to generate the raster path-loss map
+   */
+  virtual double computePathLossAt(const inet::Coord& bsCoord, const inet::Coord& coord, bool los);
+  /*
+   * Returns true if the analytic path loss does not depend on random draws,
+   * i.e. if it can be precomputed on a raster map
+   */
+  virtual bool isPathLossDeterministic() { return true; }
+  /*
+   * Loads or generates the raster path-loss map of the base station owning this channel model
+   * and registers it to the binder
+   */
+  void initPathLossMap();
+  /*
+   * Returns the raster path-loss map of the base station located at the given position,
+   * as seen from a UE-side channel model (nullptr if not available)
+   */
+  const PathLossMap* getServingPathLossMap(const inet::Coord& bsCoord);
   /*
    * Compute attenuation for indoor scenario
    *
@@ -362,6 +672,25 @@ public:
    * @param isBgUe if true, this is called for a background UE
    */
   double jakesFading(MacNodeId noedId, double speed, unsigned int band, bool cqiDl, bool isBgUe = false);
+  /*
+   * Compute Jakes fading for all the bands
+   *
+   * @param nodeid mac node id of UE
+   * @param speed speed of UE
+   * @param cqiDl if true, the jakesMap in the UE side should be used
+   * @param fading output vector, filled with the fading attenuation of each band
+   * @param isBgUe if true, this is called for a background UE
+   */
+  void computeJakesFading(MacNodeId nodeId, double speed, bool cqiDl, std::vector<double>& fading, bool isBgUe = false);
+  /*
+   * Compute the fading attenuation for all the bands, according to the configured fading type
+   * (all zeros if fading is disabled)
+   */
+  void computeFading(MacNodeId nodeId, double speed, bool cqiDl, std::vector<double>& fading, bool isBgUe = false);
+  /*
+   * Return the jakes fading data for the given node, creating them if needed
+   */
+  JakesFadingData* obtainJakesFadingData(MacNodeId nodeId, bool cqiDl, bool isBgUe);
   /*
    * Compute LOS probability
    *
@@ -375,11 +704,6 @@ public:
       return &jakesFadingMap_;
   }
 
-  ShadowFadingMap * getShadowingMap()
-  {
-      return &lastComputedSF_;
-  }
-
   virtual bool isUplinkInterferenceEnabled() { return enableUplinkInterference_; }
   virtual bool isD2DInterferenceEnabled() { return enableD2DInterference_; }
 protected:
@@ -413,17 +737,58 @@ protected:
    */
   void updatePositionHistory(const MacNodeId nodeId, const inet::Coord coord);
 
+  /*
+   * Returns the link budget computed for the given node within the current TTI, or nullptr if
+   * it is not available or no longer valid (i.e. one of the end points has moved)
+   *
+   * @param nodeid mac node id of the other end point
+   * @param cqiDl true if the shadowing map on the UE side has been used
+   * @param coord position of the other end point
+   * @param meanAttenuation true if the attenuation has been computed with the mean shadowing
+   */
+  LinkBudget* getCachedLinkBudget(MacNodeId nodeId, bool cqiDl, const inet::Coord& coord, bool meanAttenuation);
+
+  /*
+   * Stores the attenuation computed for the given node within the current TTI
+   */
+  void storeLinkBudget(MacNodeId nodeId, bool cqiDl, const inet::Coord& coord, bool meanAttenuation, double attenuation);
+
+  /*
+   * Removes the link budgets stored for the given node (e.g. when its LOS state changes)
+   */
+  void invalidateLinkBudget(MacNodeId nodeId);
+
+  /*
+   * Compute the attenuation due to the sectorial transmission of the serving eNB
+   * (zero if the eNB uses an omni-directional antenna)
+   */
+  double computeServingAngolarAttenuation(MacNodeId eNbId, MacNodeId ueId, bool cqiDl, const inet::Coord& coord, const inet::Coord& enbCoord, const inet::Coord& ueCoord);
+
   /*
    * compute total interference due to eNB coexistence for the DL direction
    * @param eNbId id of the considered eNb
    * @param isCqi if we are computing a CQI
    */
   bool computeDownlinkInterference(MacNodeId eNbId, MacNodeId ueId, inet::Coord coord, bool isCqi, double carrierFrequency, const RbMap& rbmap, std::vector<double> * interference);
+  /*
+   * Collects the cells that may interfere with the given one in DL, with their slot occupation.
+   * If coord is not null, only cells within the cutoff distance from coord are collected
+   */
+  void prepareDownlinkInterferers(MacNodeId eNbId, const inet::Coord* coord, bool isCqi, double carrierFrequency, std::vector<DlInterferer>& interferers);
+  /*
+   * Adds the DL interference perceived by the given UE from the given cells
+   */
+  void addDownlinkInterference(MacNodeId ueId, const inet::Coord& coord, bool isCqi, const RbMap& rbmap, const std::vector<DlInterferer>& interferers, std::vector<double> * interference);
 
   /*
    * compute interference coming from neighboring cells for the UL direction
    */
   bool computeUplinkInterference(MacNodeId eNbId, MacNodeId senderId, bool isCqi, double carrierFrequency, const RbMap& rbmap, std::vector<double> * interference);
+  /*
+   * Returns the UL interference perceived by the given cell, aggregated over all the interfering UEs.
+   * It is computed once for each update of the UL transmission map and published in the Binder
+   */
+  const UlInterferenceInfo* obtainAggregatedUplinkInterference(MacCellId eNbId, double carrierFrequency, UlTransmissionMapTTI t);
 
   /*
    * compute interference coming from neighboring UEs for the D2D/D2D_MULTI direction
@@ -436,6 +801,25 @@ protected:
    */
   virtual bool computeExtCellInterference(MacNodeId eNbId, MacNodeId nodeId, inet::Coord coord, bool isCqi, double carrierFrequency, std::vector<double>* interference);
 
+  /*
+   * evaluates the interference from external cells using the coupling gains cached for the
+   * grid cell containing coord. The per-band interference of a grid cell is recomputed only
+   * when the allocation of some ext cell changes
+   */
+  bool getCachedExtCellInterference(MacNodeId nodeId, const inet::Coord& coord, bool isCqi, double carrierFrequency, std::vector<double>* interference);
+
+  /*
+   * returns the linear received power from the given ext cell at the given position,
+   * including path loss and angular attenuation (but not the shadowing)
+   */
+  double computeExtCellCouplingGain(ExtCell* extCell, const inet::Coord& coord, bool los);
+
+  /*
+   * returns the linear attenuation due to the shadowing of the UE, applied to the cached
+   * ext-cell interference. Shadowing is not applied to ext cells by this model
+   */
+  virtual double getExtCellShadowingFactor(MacNodeId nodeId) { return 1.0; }
+
   /*
    * evaluates total interference from external cells seen from the spot given by coord
    * @return total interference expressed in dBm
@@ -449,17 +833,17 @@ protected:
   double computeExtCellPathLoss(double dist, MacNodeId nodeId);
 
   /*
-   * Obtain the jakes map for the specified UE
+   * Obtain the channel model of the specified UE on this carrier
+   * (nullptr if the UE does not use this carrier)
    * @param id mac id of the user
    */
-  JakesFadingMap * obtainUeJakesMap(MacNodeId id);
-  JakesFadingMap * obtainUeJakesMap_bgUe(MacNodeId id);
+  LteRealisticChannelModel* obtainUeChannelModel(MacNodeId id);
 
   /*
-   * Obtain the shadowing map for the specified UE
+   * Obtain the channel state of the specified UE, as stored in the channel model of the UE
    * @param id mac id of the user
    */
-  ShadowFadingMap* obtainShadowingMap(MacNodeId id);
+  NodeChannelState* obtainUeNodeState(MacNodeId id);
 };
 
 #endif /* STACK_PHY_CHANNELMODEL_LTEREALISTICCHANNELMODEL_H_ */
@@ -22,15 +22,33 @@ void NRChannelModel::initialize(int stage)
     LteRealisticChannelModel::initialize(stage);
 }
 
-double NRChannelModel::getAttenuation(MacNodeId nodeId, Direction dir, inet::Coord coord, bool cqiDl)
+double NRChannelModel::getAttenuation(MacNodeId nodeId, Direction dir, inet::Coord coord, bool cqiDl, bool meanAttenuation)
 {
    double movement = .0;
    double speed = .0;
 
-   //COMPUTE 3D and 2D DISTANCE between ue and eNodeB
-   double threeDimDistance = phy_->getCoord().distance(coord);
+   //COMPUTE 2D DISTANCE between ue and eNodeB
    double twoDimDistance = getTwoDimDistance(phy_->getCoord(), coord);
 
+   // if the link budget (distances, LOS state, path loss including the penetration loss, and shadowing)
+   // has already been computed during this TTI, reuse it
+   if (enableLinkBudgetCache_)
+   {
+       LinkBudget* linkBudget = getCachedLinkBudget(nodeId, cqiDl, coord, meanAttenuation);
+       if (linkBudget != nullptr)
+       {
+           linkBudgetCacheHits_++;
+           if (dir == DL)
+               emit(distance_,twoDimDistance);
+
+           EV << "NRChannelModel::getAttenuation - cached attenuation at distance " << twoDimDistance << " for eNb is " << linkBudget->attenuation << endl;
+           return linkBudget->attenuation;
+       }
+   }
+
+   //COMPUTE 3D DISTANCE between ue and eNodeB
+   double threeDimDistance = phy_->getCoord().distance(coord);
+
    if (dir == DL) // sender is UE
        speed = computeSpeed(nodeId, phy_->getCoord());
    else
@@ -39,22 +57,30 @@ double NRChannelModel::getAttenuation(MacNodeId nodeId, Direction dir, inet::Coo
    //If traveled distance is greater than correlation distance UE could have changed its state and
    // its visibility from eNodeb, hence it is correct to recompute the los probability
    if (movement > correlationDistance_
-           || losMap_.find(nodeId) == losMap_.end())
+           || !getNodeState(nodeId).hasLos)
    {
        computeLosProbability(twoDimDistance, nodeId);
+       invalidateLinkBudget(nodeId);
    }
 
    if(dir == DL)
        emit(distance_,twoDimDistance);
 
    //compute attenuation based on selected scenario and based on LOS or NLOS
-   bool los = losMap_[nodeId];
-   double attenuation = computePathLoss(threeDimDistance, twoDimDistance, los);
+   bool los = getLos(nodeId);
+   double attenuation = getPathLoss(coord, threeDimDistance, twoDimDistance, los);
 
    //    Applying shadowing only if it is enabled by configuration
    //    log-normal shadowing (not available for background UEs)
    if (nodeId < BGUE_MIN_ID && shadowing_)
-       attenuation += computeShadowing(twoDimDistance, nodeId, speed, cqiDl);
+   {
+       if (meanAttenuation)
+           attenuation += computeMeanShadowing(nodeId);
+       else if (useShadowingMap_)
+           attenuation += computeShadowingFromMap(coord, nodeId, cqiDl);
+       else
+           attenuation += computeShadowing(twoDimDistance, nodeId, speed, cqiDl);
+   }
 
    // update current user position
 
@@ -66,6 +92,12 @@ double NRChannelModel::getAttenuation(MacNodeId nodeId, Direction dir, inet::Coo
        //sender is an UE
        updatePositionHistory(nodeId, coord);
 
+   if (enableLinkBudgetCache_)
+   {
+       linkBudgetCacheMisses_++;
+       storeLinkBudget(nodeId, cqiDl, coord, meanAttenuation, attenuation);
+   }
+
    EV << "NRChannelModel::getAttenuation - computed attenuation at distance " << threeDimDistance << " for eNb is " << attenuation << endl;
 
    return attenuation;
@@ -96,7 +128,7 @@ void NRChannelModel::computeLosProbability(double d, MacNodeId nodeId)
    double p = 0;
    if (!dynamicLos_)
    {
-       losMap_[nodeId] = fixedLos_;
+       setLos(nodeId, fixedLos_);
        return;
    }
    switch (scenario_)
@@ -128,12 +160,17 @@ void NRChannelModel::computeLosProbability(double d, MacNodeId nodeId)
    }
    double random = uniform(0.0, 1.0);
    if (random <= p)
-       losMap_[nodeId] = true;
+       setLos(nodeId, true);
    else
-       losMap_[nodeId] = false;
+       setLos(nodeId, false);
 }
 
 
+double NRChannelModel::computePathLossAt(const inet::Coord& bsCoord, const inet::Coord& coord, bool los)
+{
+    return computePathLoss(bsCoord.distance(coord), getTwoDimDistance(bsCoord, coord), los);
+}
+
 double NRChannelModel::computePathLoss(double threeDimDistance, double twoDimDistance, bool los)
 {
     //compute attenuation based on selected scenario and based on LOS or NLOS
@@ -344,9 +381,13 @@ bool NRChannelModel::computeExtCellInterference(MacNodeId eNbId, MacNodeId nodeI
 {
    EV << "**** Ext Cell Interference **** " << endl;
 
+   // the coupling gains cannot be cached if the path loss model draws random numbers
+   if (enableExtCellInterferenceCache_ && isPathLossDeterministic())
+       return getCachedExtCellInterference(nodeId, coord, isCqi, carrierFrequency, interference);
+
    // get external cell list
-   ExtCellList list = binder_->getExtCellList(carrierFrequency);
-   ExtCellList::iterator it = list.begin();
+   const ExtCellList& list = binder_->getExtCellList(carrierFrequency);
+   ExtCellList::const_iterator it = list.begin();
 
    Coord c;
    double threeDimDist, // meters
@@ -431,6 +472,18 @@ bool NRChannelModel::computeExtCellInterference(MacNodeId eNbId, MacNodeId nodeI
    return true;
 }
 
+double NRChannelModel::getExtCellShadowingFactor(MacNodeId nodeId)
+{
+   if (!shadowing_)
+       return 1.0;
+
+   // the shadowing of the UE is applied to all the ext cells (see computeExtCellPathLoss)
+   NodeChannelState& state = getNodeState(nodeId);
+   if (!state.hasShadowing)
+       throw cRuntimeError("NRChannelModel::getExtCellShadowingFactor - shadowing not computed for node %d", nodeId);
+   return dBToLinear(-state.shadowing);
+}
+
 double NRChannelModel::computeExtCellPathLoss(double threeDimDistance, double twoDimDistance, MacNodeId nodeId)
 {
    // double movement = .0;
@@ -441,7 +494,7 @@ double NRChannelModel::computeExtCellPathLoss(double threeDimDistance, double tw
    //    EV << "LteRealisticChannelModel::computeExtCellPathLoss:" << scenario_ << "-" << shadowing_ << "\n";
 
    //compute attenuation based on selected scenario and based on LOS or NLOS
-   bool los = losMap_[nodeId];
+   bool los = getLos(nodeId);
 
    if(!enable_extCell_los_)
       los = false;
@@ -486,7 +539,10 @@ double NRChannelModel::computeExtCellPathLoss(double threeDimDistance, double tw
        //         if the distance traveled by the UE is smaller than correlation distance shadowing attenuation remain the same
        //        else
        {
-           att = lastComputedSF_.at(nodeId).second;
+           NodeChannelState& state = getNodeState(nodeId);
+           if (!state.hasShadowing)
+               throw cRuntimeError("NRChannelModel::computeExtCellPathLoss - shadowing not computed for node %d", nodeId);
+           att = state.shadowing;
        }
        EV << "(" << att << ")";
        attenuation += att;
@@ -26,8 +26,9 @@ public:
      * @param nodeid mac node id of UE
      * @param dir traffic direction
      * @param coord position of end point comunication (if dir==UL is the position of UE else is the position of gNodeB)
+     * @param meanAttenuation if true, the per-link shadowing is replaced by its mean effect
      */
-    virtual double getAttenuation(MacNodeId nodeId, Direction dir, inet::Coord coord, bool cqiDl);
+    virtual double getAttenuation(MacNodeId nodeId, Direction dir, inet::Coord coord, bool cqiDl, bool meanAttenuation = false);
 
     /*
     *  Compute Attenuation caused by transmission direction
@@ -53,6 +54,11 @@ public:
      */
     virtual double computePathLoss(double threeDimDistance, double twoDimDistance, bool los);
 
+    /*
+     * Compute the path loss between two positions, used to generate the raster path-loss map
+     */
+    virtual double computePathLossAt(const inet::Coord& bsCoord, const inet::Coord& coord, bool los);
+
     /*
      * 3D-InH path loss model (taken from TR 36.873)
      *
@@ -97,6 +103,11 @@ public:
      * @return attenuation expressed in dBm
      */
     double computeExtCellPathLoss(double threeDimDistance, double twoDimDistance, MacNodeId nodeId);
+
+    /*
+     * Returns the linear attenuation due to the shadowing of the UE, applied to the cached ext-cell interference
+     */
+    virtual double getExtCellShadowingFactor(MacNodeId nodeId);
 };
 
 #endif /* NRCHANNELMODEL_H_ */
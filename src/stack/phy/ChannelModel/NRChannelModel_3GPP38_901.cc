@@ -25,7 +25,7 @@ void NRChannelModel_3GPP38_901::computeLosProbability(double d, MacNodeId nodeId
    double p = 0;
    if (!dynamicLos_)
    {
-       losMap_[nodeId] = fixedLos_;
+       setLos(nodeId, fixedLos_);
        return;
    }
 
@@ -67,9 +67,9 @@ void NRChannelModel_3GPP38_901::computeLosProbability(double d, MacNodeId nodeId
 
     double random = uniform(0.0, 1.0);
     if (random <= p)
-        losMap_[nodeId] = true;
+        setLos(nodeId, true);
     else
-        losMap_[nodeId] = false;
+        setLos(nodeId, false);
 }
 
 double NRChannelModel_3GPP38_901::computePenetrationLoss(double threeDimDistance)
@@ -313,25 +313,25 @@ double NRChannelModel_3GPP38_901::getStdDev(bool dist, MacNodeId nodeId)
     switch (scenario_)
     {
     case URBAN_MICROCELL:
-        if (losMap_[nodeId])
+        if (getLos(nodeId))
             return 4.;
         else
             return 7.82;
         break;
     case INDOOR_HOTSPOT:
-        if (losMap_[nodeId])
+        if (getLos(nodeId))
             return 3.;
         else
             return 8.03;
         break;
     case URBAN_MACROCELL:
-        if (losMap_[nodeId])
+        if (getLos(nodeId))
             return 4.;
         else
             return 6.;
         break;
     case RURAL_MACROCELL:
-        if (losMap_[nodeId])
+        if (getLos(nodeId))
         {
             if (dist)
                 return 4.;
@@ -347,17 +347,22 @@ double NRChannelModel_3GPP38_901::getStdDev(bool dist, MacNodeId nodeId)
     return 0.0;
 }
 
+double NRChannelModel_3GPP38_901::getShadowingStdDev(MacNodeId nodeId)
+{
+    return getStdDev(false, nodeId);
+}
+
 double NRChannelModel_3GPP38_901::computeShadowing(double sqrDistance, MacNodeId nodeId, double speed, bool cqiDl)
 {
-    ShadowFadingMap* actualShadowingMap;
+    NodeChannelState* state;
 
-    if (cqiDl) // if we are computing a DL CQI we need the Shadowing Map stored on the UE side
-        actualShadowingMap = obtainShadowingMap(nodeId);
+    if (cqiDl) // if we are computing a DL CQI we need the Shadowing stored on the UE side
+        state = obtainUeNodeState(nodeId);
     else
-        actualShadowingMap = &lastComputedSF_;
+        state = &getNodeState(nodeId);
 
-    if (actualShadowingMap == nullptr)
-        throw cRuntimeError("NRChannelModel_3GPP38_901::computeShadowing - actualShadowingMap not found (nullptr)");
+    if (state == nullptr)
+        throw cRuntimeError("NRChannelModel_3GPP38_901::computeShadowing - node state not found (nullptr)");
 
     double mean = 0;
     double dbp = 0.0;
@@ -374,23 +379,24 @@ double NRChannelModel_3GPP38_901::computeShadowing(double sqrDistance, MacNodeId
     // the Move object associated to the UE is move variable
 
     // if shadowing for current user has never been computed
-    if (actualShadowingMap->find(nodeId) == actualShadowingMap->end())
+    if (!state->hasShadowing)
     {
         //Get the log normal shadowing with std deviation stdDev
         att = normal(mean, stdDev);
 
         //store the shadowing attenuation for this user and the temporal mark
-        std::pair<simtime_t, double> tmp(NOW, att);
-        (*actualShadowingMap)[nodeId] = tmp;
+        state->hasShadowing = true;
+        state->shadowingTime = NOW;
+        state->shadowing = att;
 
         //If the shadowing attenuation has been computed at least one time for this user
         // and the distance traveled by the UE is greated than correlation distance
     }
-    else if ((NOW - actualShadowingMap->at(nodeId).first).dbl() * speed
+    else if ((NOW - state->shadowingTime).dbl() * speed
             > correlationDistance_)
     {
         //get the temporal mark of the last computed shadowing attenuation
-        time = (NOW - actualShadowingMap->at(nodeId).first).dbl();
+        time = (NOW - state->shadowingTime).dbl();
 
         //compute the traveled distance
         space = time * speed;
@@ -399,20 +405,20 @@ double NRChannelModel_3GPP38_901::computeShadowing(double sqrDistance, MacNodeId
         double a = exp(-0.5 * (space / correlationDistance_));
 
         //Get last shadowing attenuation computed
-        double old = actualShadowingMap->at(nodeId).second;
+        double old = state->shadowing;
 
         //Compute shadowing with a EAW (Exponential Average Window) (step2)
         att = a * old + sqrt(1 - pow(a, 2)) * normal(mean, stdDev);
 
         // Store the new computed shadowing
-        std::pair<simtime_t, double> tmp(NOW, att);
-        (*actualShadowingMap)[nodeId] = tmp;
+        state->shadowingTime = NOW;
+        state->shadowing = att;
 
         // if the distance traveled by the UE is smaller than correlation distance shadowing attenuation remain the same
     }
     else
     {
-        att = actualShadowingMap->at(nodeId).second;
+        att = state->shadowing;
     }
     EV <<  " NRChannelModel_3GPP38_901::computeShadowing - shadowing att = " << att << endl;
 
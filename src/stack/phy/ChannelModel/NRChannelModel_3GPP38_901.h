@@ -52,6 +52,12 @@ public:
      */
     virtual double computePathLoss(double threeDimDistance, double twoDimDistance, bool los);
 
+    /*
+     * The UMa model and the building penetration loss include random draws,
+     * hence they cannot be precomputed on a raster map
+     */
+    virtual bool isPathLossDeterministic() { return !inside_building_ && scenario_ != URBAN_MACROCELL; }
+
     /*
      * UMa path loss model (taken from TR 38.901)
      *
@@ -101,6 +107,11 @@ public:
      */
     virtual double computeShadowing(double sqrDistance, MacNodeId nodeId, double speed, bool cqiDl);
 
+    /*
+     * Returns the standard deviation of the shadowing for the given UE (taken from TR 38.901)
+     */
+    virtual double getShadowingStdDev(MacNodeId nodeId);
+
 };
 
 #endif /* NRChannelModel_3GPP38_901_H_ */
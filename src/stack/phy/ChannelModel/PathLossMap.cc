@@ -0,0 +1,114 @@
+//
+//                  Simu5G
+//
+// Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include "stack/phy/ChannelModel/PathLossMap.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+using namespace omnetpp;
+
+static const char PATHLOSS_MAP_MAGIC[4] = { 'P', 'L', 'M', '1' };
+
+PathLossMap::PathLossMap()
+{
+    originX_ = 0.0;
+    originY_ = 0.0;
+    resolution_ = 1.0;
+    numX_ = 0;
+    numY_ = 0;
+}
+
+void PathLossMap::init(double originX, double originY, double resolution, unsigned int numX, unsigned int numY)
+{
+    if (resolution <= 0 || numX < 2 || numY < 2)
+        throw cRuntimeError("PathLossMap::init - invalid grid: resolution %f, size %dx%d", resolution, numX, numY);
+
+    originX_ = originX;
+    originY_ = originY;
+    resolution_ = resolution;
+    numX_ = numX;
+    numY_ = numY;
+    values_.assign(2 * (size_t)numX_ * numY_, std::numeric_limits<float>::quiet_NaN());
+}
+
+void PathLossMap::load(const char* filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    if (!in)
+        throw cRuntimeError("PathLossMap::load - cannot open file %s", filename);
+
+    char magic[4];
+    double originX, originY, resolution;
+    uint32_t numX, numY;
+    in.read(magic, sizeof(magic));
+    in.read((char*)&originX, sizeof(originX));
+    in.read((char*)&originY, sizeof(originY));
+    in.read((char*)&resolution, sizeof(resolution));
+    in.read((char*)&numX, sizeof(numX));
+    in.read((char*)&numY, sizeof(numY));
+    if (!in || memcmp(magic, PATHLOSS_MAP_MAGIC, sizeof(magic)) != 0)
+        throw cRuntimeError("PathLossMap::load - %s is not a valid path-loss map", filename);
+
+    init(originX, originY, resolution, numX, numY);
+    in.read((char*)values_.data(), values_.size() * sizeof(float));
+    if (!in)
+        throw cRuntimeError("PathLossMap::load - %s is truncated", filename);
+}
+
+void PathLossMap::save(const char* filename) const
+{
+    std::ofstream out(filename, std::ios::binary);
+    if (!out)
+        throw cRuntimeError("PathLossMap::save - cannot open file %s", filename);
+
+    uint32_t numX = numX_, numY = numY_;
+    out.write(PATHLOSS_MAP_MAGIC, sizeof(PATHLOSS_MAP_MAGIC));
+    out.write((const char*)&originX_, sizeof(originX_));
+    out.write((const char*)&originY_, sizeof(originY_));
+    out.write((const char*)&resolution_, sizeof(resolution_));
+    out.write((const char*)&numX, sizeof(numX));
+    out.write((const char*)&numY, sizeof(numY));
+    out.write((const char*)values_.data(), values_.size() * sizeof(float));
+    if (!out)
+        throw cRuntimeError("PathLossMap::save - error while writing %s", filename);
+}
+
+bool PathLossMap::getPathLoss(double x, double y, bool los, double& pathLoss) const
+{
+    if (values_.empty())
+        return false;
+
+    double fx = (x - originX_) / resolution_;
+    double fy = (y - originY_) / resolution_;
+    if (fx < 0 || fy < 0)
+        return false;
+
+    unsigned int ix = (unsigned int)fx;
+    unsigned int iy = (unsigned int)fy;
+    if (ix + 1 >= numX_ || iy + 1 >= numY_)
+        return false;
+
+    const float* row = &values_[((los ? 1 : 0) * numY_ + iy) * numX_ + ix];
+    double v00 = row[0];
+    double v10 = row[1];
+    double v01 = row[numX_];
+    double v11 = row[numX_ + 1];
+    if (std::isnan(v00) || std::isnan(v10) || std::isnan(v01) || std::isnan(v11))
+        return false;
+
+    double dx = fx - ix;
+    double dy = fy - iy;
+    pathLoss = (v00 * (1 - dx) + v10 * dx) * (1 - dy) + (v01 * (1 - dx) + v11 * dx) * dy;
+    return true;
+}
@@ -0,0 +1,86 @@
+//
+//                  Simu5G
+//
+// Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef STACK_PHY_CHANNELMODEL_PATHLOSSMAP_H_
+#define STACK_PHY_CHANNELMODEL_PATHLOSSMAP_H_
+
+#include <omnetpp.h>
+#include <vector>
+
+/*
+ * Raster of path-loss values (dB) towards a static base station, sampled
+ * on a regular grid of the x-y plane. Two layers are stored, one for NLOS
+ * and one for LOS conditions. Points where the path loss is not available
+ * are marked with NaN.
+ *
+ * Binary file format (native byte order):
+ *   char[4]   magic "PLM1"
+ *   double    x of the grid origin (m)
+ *   double    y of the grid origin (m)
+ *   double    grid resolution (m)
+ *   uint32    number of points along x
+ *   uint32    number of points along y
+ *   float[2][numY][numX]  path loss (dB), NLOS layer first
+ */
+class PathLossMap
+{
+    double originX_;
+    double originY_;
+    double resolution_;
+    unsigned int numX_;
+    unsigned int numY_;
+
+    // path loss values, indexed by (los * numY_ + y) * numX_ + x
+    std::vector<float> values_;
+
+  public:
+    PathLossMap();
+
+    /*
+     * Allocates the grid, with all values marked as not available
+     */
+    void init(double originX, double originY, double resolution, unsigned int numX, unsigned int numY);
+
+    /*
+     * Loads the grid from the given binary file
+     */
+    void load(const char* filename);
+
+    /*
+     * Stores the grid into the given binary file
+     */
+    void save(const char* filename) const;
+
+    bool empty() const { return values_.empty(); }
+
+    unsigned int getNumX() const { return numX_; }
+    unsigned int getNumY() const { return numY_; }
+
+    // returns the coordinates of the given grid point
+    double getPointX(unsigned int x) const { return originX_ + x * resolution_; }
+    double getPointY(unsigned int y) const { return originY_ + y * resolution_; }
+
+    void setValue(unsigned int x, unsigned int y, bool los, double pathLoss)
+    {
+        values_[((los ? 1 : 0) * numY_ + y) * numX_ + x] = (float)pathLoss;
+    }
+
+    /*
+     * Computes the path loss at the given position by bilinear interpolation
+     * of the four surrounding grid points.
+     *
+     * @return false if the position is outside the grid or one of the
+     *         surrounding points is not available
+     */
+    bool getPathLoss(double x, double y, bool los, double& pathLoss) const;
+};
+
+#endif
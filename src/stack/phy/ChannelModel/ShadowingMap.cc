@@ -0,0 +1,83 @@
+//
+//                  Simu5G
+//
+// Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include "stack/phy/ChannelModel/ShadowingMap.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace omnetpp;
+
+ShadowingMap::ShadowingMap()
+{
+    originX_ = 0.0;
+    originY_ = 0.0;
+    resolution_ = 1.0;
+    numX_ = 0;
+    numY_ = 0;
+}
+
+void ShadowingMap::generate(cRNG* rng, double originX, double originY, double resolution,
+        unsigned int numX, unsigned int numY, double correlationDistance)
+{
+    if (resolution <= 0 || numX < 2 || numY < 2 || correlationDistance <= 0)
+        throw cRuntimeError("ShadowingMap::generate - invalid grid: resolution %f, size %dx%d, correlation distance %f",
+                resolution, numX, numY, correlationDistance);
+
+    originX_ = originX;
+    originY_ = originY;
+    resolution_ = resolution;
+    numX_ = numX;
+    numY_ = numY;
+
+    // correlation between adjacent grid points
+    double a = exp(-resolution_ / correlationDistance);
+    double b = sqrt(1 - a * a);
+
+    std::vector<double> field((size_t)numX_ * numY_);
+
+    // filter along x: rows are independent, each sample has unit variance
+    for (unsigned int y = 0; y < numY_; y++)
+    {
+        double* row = &field[(size_t)y * numX_];
+        row[0] = normal(rng, 0.0, 1.0);
+        for (unsigned int x = 1; x < numX_; x++)
+            row[x] = a * row[x - 1] + b * normal(rng, 0.0, 1.0);
+    }
+
+    // filter along y: the input samples of each column are independent
+    for (unsigned int y = 1; y < numY_; y++)
+    {
+        double* row = &field[(size_t)y * numX_];
+        const double* prevRow = row - numX_;
+        for (unsigned int x = 0; x < numX_; x++)
+            row[x] = a * prevRow[x] + b * row[x];
+    }
+
+    values_.assign(field.begin(), field.end());
+}
+
+double ShadowingMap::getValue(double x, double y) const
+{
+    if (values_.empty())
+        return 0.0;
+
+    // clamp to the grid
+    double fx = std::min(std::max((x - originX_) / resolution_, 0.0), (double)(numX_ - 1));
+    double fy = std::min(std::max((y - originY_) / resolution_, 0.0), (double)(numY_ - 1));
+
+    unsigned int ix = std::min((unsigned int)fx, numX_ - 2);
+    unsigned int iy = std::min((unsigned int)fy, numY_ - 2);
+    double dx = fx - ix;
+    double dy = fy - iy;
+
+    const float* row = &values_[(size_t)iy * numX_ + ix];
+    return (row[0] * (1 - dx) + row[1] * dx) * (1 - dy) + (row[numX_] * (1 - dx) + row[numX_ + 1] * dx) * dy;
+}
@@ -0,0 +1,59 @@
+//
+//                  Simu5G
+//
+// Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef STACK_PHY_CHANNELMODEL_SHADOWINGMAP_H_
+#define STACK_PHY_CHANNELMODEL_SHADOWINGMAP_H_
+
+#include <omnetpp.h>
+#include <vector>
+
+/*
+ * Spatially correlated shadowing field around a base station, sampled on a
+ * regular grid of the x-y plane. Values are zero-mean and unit-variance, and
+ * must be scaled by the standard deviation of the shadowing.
+ *
+ * The field is obtained by filtering white Gaussian noise with a first-order
+ * autoregressive filter along x and then along y, which gives the exponential
+ * correlation exp(-|dx|/dcorr) * exp(-|dy|/dcorr) (Gudmundson model applied
+ * to each axis)
+ */
+class ShadowingMap
+{
+    double originX_;
+    double originY_;
+    double resolution_;
+    unsigned int numX_;
+    unsigned int numY_;
+
+    // field values, indexed by y * numX_ + x
+    std::vector<float> values_;
+
+  public:
+    ShadowingMap();
+
+    /*
+     * Generates the field, drawing the samples from the given RNG
+     *
+     * @param correlationDistance decorrelation distance (m)
+     */
+    void generate(omnetpp::cRNG* rng, double originX, double originY, double resolution,
+            unsigned int numX, unsigned int numY, double correlationDistance);
+
+    bool empty() const { return values_.empty(); }
+
+    /*
+     * Returns the field at the given position by bilinear interpolation.
+     * Positions outside the grid take the value of the closest border
+     */
+    double getValue(double x, double y) const;
+};
+
+#endif
@@ -11,6 +11,8 @@
 
 #include "stack/phy/feedback/LteDlFeedbackGenerator.h"
 #include "stack/phy/layer/LtePhyUe.h"
+#include "stack/mac/layer/LteMacEnb.h"
+#include "stack/phy/ChannelModel/LteRealisticChannelModel.h"
 
 Define_Module(LteDlFeedbackGenerator);
 
@@ -66,6 +68,18 @@ void LteDlFeedbackGenerator::initialize(int stage)
         tAperiodicTx_ = new TTimer(this);
         tAperiodicTx_->setTimerId(APERIODIC_TX);
         feedbackComputationPisa_ = false;
+
+        eventDrivenFeedback_ = par("eventDrivenFeedback");
+        fbDistanceThreshold_ = par("fbDistanceThreshold");
+        fbInterferenceThreshold_ = par("fbInterferenceThreshold");
+        fbMaxAge_ = (simtime_t)(int(par("fbMaxAge")) * TTI);// TTI -> seconds
+        if (eventDrivenFeedback_ && fbMaxAge_ < fbPeriod_)
+            throw cRuntimeError("LteDlFeedbackGenerator::initialize - fbMaxAge must not be lower than fbPeriod");
+        phyUe_ = nullptr;
+        lastReportValid_ = false;
+        lastReportTime_ = 0;
+        lastInterferenceLoad_ = 0.0;
+
         WATCH(fbType_);
         WATCH(rbAllocationType_);
         WATCH(fbPeriod_);
@@ -91,6 +105,7 @@ void LteDlFeedbackGenerator::initialize(int stage)
         EV << "DLFeedbackGenerator Stage " << stage << " nodeid: " << nodeId_
            << " phyUe taken" << endl;
         dasFilter_ = tmp->getDasFilter();
+        phyUe_ = tmp;
         EV << "DLFeedbackGenerator Stage " << stage << " nodeid: " << nodeId_
            << " phyUe used" << endl;
 //        initializeFeedbackComputation(par("feedbackComputation").xmlValue());
@@ -120,7 +135,12 @@ void LteDlFeedbackGenerator::handleMessage(cMessage *msg)
         EV << NOW << " Periodic Sensing" << endl;
         tPeriodicSensing_->handle();
         tPeriodicSensing_->start(fbPeriod_);
-        sensing(PERIODIC);
+        if (eventDrivenFeedback_ && !isFeedbackNeeded())
+        {
+            EV << NOW << " Channel state unchanged: skip Periodic" << endl;
+        }
+        else
+            sensing(PERIODIC);
     }
     else if (type == PERIODIC_TX)
     {
@@ -189,6 +209,9 @@ void LteDlFeedbackGenerator::sensing(FbPeriodicity per)
         tPeriodicTx_->stop();
     }
 
+    if (eventDrivenFeedback_)
+        storeReportState();
+
     // Schedule feedback transmission
     if (per == PERIODIC)
         tPeriodicTx_->start(fbDelay_);
@@ -196,6 +219,88 @@ void LteDlFeedbackGenerator::sensing(FbPeriodicity per)
         tAperiodicTx_->start(fbDelay_);
 }
 
+double LteDlFeedbackGenerator::computeInterferenceLoad()
+{
+    unsigned int allocatedBands = 0;
+    unsigned int totBands = 0;
+
+    const LteChannelModel* channelModel = phyUe_->getPrimaryChannelModel();
+    if (channelModel == nullptr)
+        return 0.0;
+    double carrierFrequency = channelModel->getCarrierFrequency();
+
+    // only the cells within the interference cutoff distance can interfere
+    Binder* binder = getBinder();
+    std::vector<EnbInfo*>* enbList = binder->getEnbList();
+    const LteRealisticChannelModel* realChan = dynamic_cast<const LteRealisticChannelModel*>(channelModel);
+    if (realChan != nullptr && realChan->getDownlinkInterferenceCutoffDistance() > 0)
+    {
+        binder->getEnbsInRange(carrierFrequency, phyUe_->getCoord(), realChan->getDownlinkInterferenceCutoffDistance(), interferingEnbs_);
+        enbList = &interferingEnbs_;
+    }
+
+    std::vector<EnbInfo*>::iterator it = enbList->begin(), et = enbList->end();
+    for (; it != et; ++it)
+    {
+        // the serving cell is not an interferer
+        if ((*it)->id == masterId_)
+            continue;
+
+        LtePhyBase* phy = ((*it)->init) ? (*it)->phy : check_and_cast<LtePhyBase*>((*it)->eNodeB->getSubmodule("cellularNic")->getSubmodule("phy"));
+
+        // if the cell does not use the carrier of the UE, skip it
+        LteChannelModel* interfChanModel = phy->getChannelModel(carrierFrequency);
+        if (interfChanModel == nullptr)
+            continue;
+
+        LteMacEnb* mac = ((*it)->init) ? (*it)->mac : check_and_cast<LteMacEnb*>(getMacByMacNodeId((*it)->id));
+
+        // use the allocation of the previous TTI, as the one of the current TTI might be in progress
+        unsigned int numBands = interfChanModel->getNumBands();
+        for (unsigned int b = 0; b < numBands; b++)
+        {
+            if (mac->getDlPrevBandStatus(b) > 0)
+                allocatedBands++;
+            totBands++;
+        }
+    }
+    return (totBands > 0) ? (double)allocatedBands / totBands : 0.0;
+}
+
+bool LteDlFeedbackGenerator::isFeedbackNeeded()
+{
+    if (!lastReportValid_)
+        return true;
+
+    if (NOW - lastReportTime_ >= fbMaxAge_)
+    {
+        EV << NOW << " LteDlFeedbackGenerator::isFeedbackNeeded - last report is too old" << endl;
+        return true;
+    }
+
+    if (phyUe_->getCoord().distance(lastReportPosition_) > fbDistanceThreshold_)
+    {
+        EV << NOW << " LteDlFeedbackGenerator::isFeedbackNeeded - UE moved beyond the threshold" << endl;
+        return true;
+    }
+
+    if (fabs(computeInterferenceLoad() - lastInterferenceLoad_) > fbInterferenceThreshold_)
+    {
+        EV << NOW << " LteDlFeedbackGenerator::isFeedbackNeeded - interference changed beyond the threshold" << endl;
+        return true;
+    }
+
+    return false;
+}
+
+void LteDlFeedbackGenerator::storeReportState()
+{
+    lastReportValid_ = true;
+    lastReportTime_ = NOW;
+    lastReportPosition_ = phyUe_->getCoord();
+    lastInterferenceLoad_ = computeInterferenceLoad();
+}
+
         /***************************
          *    PUBLIC FUNCTIONS
          ***************************/
@@ -275,6 +380,10 @@ void LteDlFeedbackGenerator::handleHandover(MacCellId newEnbId)
 {
     Enter_Method("LteDlFeedbackGenerator::handleHandover()");
     masterId_ = newEnbId;
+
+    // the new serving cell has no report from this UE yet
+    lastReportValid_ = false;
+
     if (masterId_ != 0)
     {
         initCellInfo();
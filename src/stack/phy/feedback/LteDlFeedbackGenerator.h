@@ -23,6 +23,7 @@
 #include "stack/phy/feedback/LteFeedbackComputation.h"
 
 class DasFilter;
+class LtePhyUe;
 /**
  * @class LteDlFeedbackGenerator
  * @brief Lte Downlink Feedback Generator
@@ -76,6 +77,26 @@ class LteDlFeedbackGenerator : public omnetpp::cSimpleModule
     MacNodeId nodeId_;
 
     bool feedbackComputationPisa_;
+
+    /*
+     * Event-driven feedback.
+     * When enabled, periodic sensing is suppressed unless the UE moved more than
+     * fbDistanceThreshold_ since the last report, the DL load of the interfering
+     * cells changed by more than fbInterferenceThreshold_, or the last report is
+     * older than fbMaxAge_. The eNB keeps using the last reported CQI meanwhile.
+     */
+    bool eventDrivenFeedback_;
+    double fbDistanceThreshold_;
+    double fbInterferenceThreshold_;
+    omnetpp::simtime_t fbMaxAge_;
+
+    LtePhyUe* phyUe_;                       /// reference to the UE PHY, used to read the position
+    bool lastReportValid_;                  /// false if a report must be sent at the next sensing
+    inet::Coord lastReportPosition_;        /// UE position at the last report
+    omnetpp::simtime_t lastReportTime_;     /// time of the last report
+    double lastInterferenceLoad_;           /// DL load of the interfering cells at the last report
+    std::vector<EnbInfo*> interferingEnbs_; /// scratch vector storing the cells within the DL interference cutoff
+
     private:
 
     // initialize cell information
@@ -89,6 +110,20 @@ class LteDlFeedbackGenerator : public omnetpp::cSimpleModule
 
     LteFeedbackComputation* getFeedbackComputationFromName(std::string name, ParameterMap& params);
 
+    /*
+     * Returns the fraction of DL bands allocated in the previous TTI by the cells other than
+     * the serving one, using the carrier of the UE and within the DL interference cutoff distance
+     */
+    double computeInterferenceLoad();
+
+    /*
+     * In event-driven mode, returns true if a new periodic report is needed
+     */
+    bool isFeedbackNeeded();
+
+    // stores the state of the UE at the time of the report
+    void storeReportState();
+
 
   protected:
 
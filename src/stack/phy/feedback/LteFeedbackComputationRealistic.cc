@@ -27,8 +27,7 @@ LteFeedbackComputationRealistic::LteFeedbackComputationRealistic(double targetBl
     lambdaMaxTh_ = lambdaMaxTh;
     lambdaRatioTh_ = lambdaRatioTh;
     phyPisaData_ = &(getBinder()->phyPisaData);
-
-    baseMin_.resize(phyPisaData_->nMcs(), 2);
+    targetBlerIndex_ = phyPisaData_->registerTargetBler(targetBler_);
 }
 
 LteFeedbackComputationRealistic::~LteFeedbackComputationRealistic()
@@ -37,7 +36,7 @@ LteFeedbackComputationRealistic::~LteFeedbackComputationRealistic()
 }
 
 void LteFeedbackComputationRealistic::generateBaseFeedback(int numBands, int numPreferredBands, LteFeedback& fb,
-    FeedbackType fbType, int cw, RbAllocationType rbAllocationType, TxMode txmode, std::vector<double> snr)
+    FeedbackType fbType, int cw, RbAllocationType rbAllocationType, TxMode txmode, const std::vector<double>& snr)
 {
     int layer = 1;
     std::vector<CqiVector> cqiTmp2;
@@ -110,35 +109,17 @@ unsigned int LteFeedbackComputationRealistic::computeRank(MacNodeId id)
 
 Cqi LteFeedbackComputationRealistic::getCqi(TxMode txmode, double snr)
 {
-    int newsnr = floor(snr + 0.5);
-    if (newsnr < phyPisaData_->minSnr())
-        return 0;
-    if (newsnr > phyPisaData_->maxSnr())
-        return 15;
-    unsigned int txm = txModeToIndex[txmode];
-    std::vector<double> min;
-    int found = 0;
-    double low = 2;
-
-    min = baseMin_;
-    for (int i = 0; i < phyPisaData_->nMcs(); i++)
-    {
-        double tmp = phyPisaData_->getBler(txm, i, newsnr);
-        double diff = targetBler_ - tmp;
-        min[i] = (diff > 0) ? diff : (diff * -1);
-        if (low >= min[i])
-        {
-            found = i;
-            low = min[i];
-        }
-    }
-    return found + 1;
+    // round the SINR to the resolution of the BLER tables
+    double resolution = phyPisaData_->getBlerTableResolution();
+    double newsnr = floor(snr / resolution + 0.5) * resolution;
+    // the BLER curves do not depend on the transmission mode
+    return phyPisaData_->getCqi(newsnr, targetBlerIndex_);
 }
 
 LteFeedbackDoubleVector LteFeedbackComputationRealistic::computeFeedback(FeedbackType fbType,
     RbAllocationType rbAllocationType, TxMode currentTxMode,
     std::map<Remote, int> antennaCws, int numPreferredBands, FeedbackGeneratorType feedbackGeneratortype, int numRus,
-    std::vector<double> snr, MacNodeId id)
+    const std::vector<double>& snr, MacNodeId id)
 {
     //add enodeB to the number of antenna
     numRus++;
@@ -189,7 +170,7 @@ LteFeedbackDoubleVector LteFeedbackComputationRealistic::computeFeedback(Feedbac
 LteFeedbackVector LteFeedbackComputationRealistic::computeFeedback(const Remote remote, FeedbackType fbType,
     RbAllocationType rbAllocationType, TxMode currentTxMode,
     int antennaCws, int numPreferredBands, FeedbackGeneratorType feedbackGeneratortype, int numRus,
-    std::vector<double> snr, MacNodeId id)
+    const std::vector<double>& snr, MacNodeId id)
 {
     // New Feedback
     LteFeedbackVector fbv;
@@ -231,7 +212,7 @@ LteFeedbackVector LteFeedbackComputationRealistic::computeFeedback(const Remote
 LteFeedback LteFeedbackComputationRealistic::computeFeedback(const Remote remote, TxMode txmode, FeedbackType fbType,
     RbAllocationType rbAllocationType,
     int antennaCws, int numPreferredBands, FeedbackGeneratorType feedbackGeneratortype, int numRus,
-    std::vector<double> snr, MacNodeId id)
+    const std::vector<double>& snr, MacNodeId id)
 {
     // New Feedback
     LteFeedback fb;
@@ -261,10 +242,10 @@ LteFeedback LteFeedbackComputationRealistic::computeFeedback(const Remote remote
     return fb;
 }
 
-double LteFeedbackComputationRealistic::meanSnr(std::vector<double> snr)
+double LteFeedbackComputationRealistic::meanSnr(const std::vector<double>& snr)
 {
     double mean = 0;
-    std::vector<double>::iterator it;
+    std::vector<double>::const_iterator it;
     for (it = snr.begin(); it != snr.end(); ++it)
         mean += *it;
     mean /= snr.size();
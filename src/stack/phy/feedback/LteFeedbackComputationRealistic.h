@@ -21,6 +21,8 @@ class LteFeedbackComputationRealistic : public LteFeedbackComputation
     std::map<MacNodeId, Lambda>* lambda_;
     //Target Bler
     double targetBler_;
+    //Index of the target Bler in the CQI tables of PhyPisaData
+    unsigned int targetBlerIndex_;
     //Number of logical bands
     unsigned int numBands_;
     //Lambda threshold
@@ -30,17 +32,15 @@ class LteFeedbackComputationRealistic : public LteFeedbackComputation
     //pointer to pisadata
     PhyPisaData* phyPisaData_;
 
-    std::vector<double> baseMin_;
-
   protected:
     // Rank computation
     unsigned int computeRank(MacNodeId id);
     // Generate base feedback for all types of feedback(allbands, preferred, wideband)
     void generateBaseFeedback(int numBands, int numPreferredBabds, LteFeedback& fb, FeedbackType fbType, int cw,
-        RbAllocationType rbAllocationType, TxMode txmode, std::vector<double> snr);
+        RbAllocationType rbAllocationType, TxMode txmode, const std::vector<double>& snr);
     // Get cqi from BLer Curves
     Cqi getCqi(TxMode txmode, double snr);
-    double meanSnr(std::vector<double> snr);
+    double meanSnr(const std::vector<double>& snr);
     public:
     LteFeedbackComputationRealistic(double targetBler, std::map<MacNodeId, Lambda>* lambda, double lambdaMinTh,
         double lambdaMaxTh, double lambdaRatioTh, unsigned int numBands);
@@ -49,17 +49,17 @@ class LteFeedbackComputationRealistic : public LteFeedbackComputation
     virtual LteFeedbackDoubleVector computeFeedback(FeedbackType fbType, RbAllocationType rbAllocationType,
         TxMode currentTxMode,
         std::map<Remote, int> antennaCws, int numPreferredBands, FeedbackGeneratorType feedbackGeneratortype,
-        int numRus, std::vector<double> snr, MacNodeId id = 0);
+        int numRus, const std::vector<double>& snr, MacNodeId id = 0);
 
     virtual LteFeedbackVector computeFeedback(const Remote remote, FeedbackType fbType,
         RbAllocationType rbAllocationType, TxMode currentTxMode,
         int antennaCws, int numPreferredBands, FeedbackGeneratorType feedbackGeneratortype, int numRus,
-        std::vector<double> snr, MacNodeId id = 0);
+        const std::vector<double>& snr, MacNodeId id = 0);
 
     virtual LteFeedback computeFeedback(const Remote remote, TxMode txmode, FeedbackType fbType,
         RbAllocationType rbAllocationType,
         int antennaCws, int numPreferredBands, FeedbackGeneratorType feedbackGeneratortype, int numRus,
-        std::vector<double> snr, MacNodeId id = 0);
+        const std::vector<double>& snr, MacNodeId id = 0);
 };
 
 #endif
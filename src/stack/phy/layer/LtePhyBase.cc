@@ -9,8 +9,11 @@
 // and cannot be removed from it.
 //
 
+#include <algorithm>
+
 #include "stack/phy/layer/LtePhyBase.h"
 #include "common/LteCommon.h"
+#include "world/radio/LteChannelControl.h"
 
 using namespace omnetpp;
 
@@ -50,6 +53,8 @@ void LtePhyBase::initialize(int stage)
 
         multicastD2DRange_ = par("multicastD2DRange");
         enableMulticastD2DRangeCheck_ = par("enableMulticastD2DRangeCheck");
+        enableBroadcastRangeCheck_ = par("enableBroadcastRangeCheck");
+        broadcastRange_ = par("broadcastRange");
     }
     else if (stage == inet::INITSTAGE_PHYSICAL_LAYER)
     {
@@ -198,6 +203,16 @@ void LtePhyBase::updateDisplayString()
 
 void LtePhyBase::sendBroadcast(LteAirFrame *airFrame)
 {
+    if (enableBroadcastRangeCheck_)
+    {
+        LteChannelControl* lteCc = dynamic_cast<LteChannelControl*>(cc);
+        if (lteCc != nullptr)
+        {
+            // only radios within broadcastRange_ receive a copy of the airframe
+            lteCc->sendToChannelInRange(myRadioRef, airFrame, broadcastRange_);
+            return;
+        }
+    }
     // delegate the ChannelControl to send the airframe
     sendToChannel(airFrame);
 }
@@ -225,47 +240,108 @@ void LtePhyBase::sendMulticast(LteAirFrame *frame)
         throw cRuntimeError("LtePhyBase::sendMulticast - Error. Group ID %d is not valid.", groupId);
 
     // send the frame to nodes belonging to the multicast group only
-    std::map<int, OmnetId>::const_iterator nodeIt = binder_->getNodeIdListBegin();
-    for (; nodeIt != binder_->getNodeIdListEnd(); ++nodeIt)
+    const std::set<MacNodeId>* members = binder_->getMulticastGroupMembers(groupId);
+    if (members != nullptr)
     {
-        MacNodeId destId = nodeIt->first;
+        if (enableMulticastD2DRangeCheck_)
+        {
+            // only consider the members located close to this node
+            getMulticastCandidates(groupId, *members, multicastCandidates_);
+            for (MacNodeId destId : multicastCandidates_)
+                sendMulticastToNode(frame, destId);
+        }
+        else
+        {
+            for (MacNodeId destId : *members)
+                sendMulticastToNode(frame, destId);
+        }
+    }
 
-        // if the node in the list does not use the same LTE/NR technology of this PHY module, skip it
-        if (isNrUe(destId) != isNr_)
-            continue;
+    // delete the original frame
+    delete frame;
+}
 
-        if (destId != nodeId_ && binder_->isInMulticastGroup(nodeIt->first, groupId))
-        {
-            EV << NOW << " LtePhyBase::sendMulticast - node " << destId << " is in the multicast group"<< endl;
+void LtePhyBase::sendMulticastToNode(LteAirFrame *frame, MacNodeId destId)
+{
+    // if the node in the list does not use the same LTE/NR technology of this PHY module, skip it
+    if (isNrUe(destId) != isNr_)
+        return;
 
-            // get a pointer to receiving module
-            cModule *receiver = getSimulation()->getModule(nodeIt->second);
-            LtePhyBase * recvPhy;
-            double dist;
+    if (destId == nodeId_)
+        return;
 
-            if( enableMulticastD2DRangeCheck_ )
-            {
-                // get the correct PHY layer module
-                recvPhy =  (isNrUe(destId)) ? check_and_cast<LtePhyBase *>(receiver->getSubmodule("cellularNic")->getSubmodule("nrPhy"))
-                                  : check_and_cast<LtePhyBase *>(receiver->getSubmodule("cellularNic")->getSubmodule("phy"));
+    // skip nodes that are no longer registered
+    OmnetId destOmnetId = binder_->getOmnetId(destId);
+    if (destOmnetId == 0)
+        return;
 
-                dist = recvPhy->getRadioPosition().distance(getRadioPosition());
+    EV << NOW << " LtePhyBase::sendMulticast - node " << destId << " is in the multicast group"<< endl;
 
-                if( dist > multicastD2DRange_ )
-                {
-                    EV << NOW << " LtePhyBase::sendMulticast - node too far (" << dist << " > " << multicastD2DRange_ << ". skipping transmission" << endl;
-                    continue;
-                }
-            }
+    // get a pointer to receiving module
+    cModule *receiver = getSimulation()->getModule(destOmnetId);
 
-            EV << NOW << " LtePhyBase::sendMulticast - sending frame to node " << destId << endl;
+    if( enableMulticastD2DRangeCheck_ )
+    {
+        double dist = getUePhy(receiver, destId)->getRadioPosition().distance(getRadioPosition());
 
-            sendDirect(frame->dup(), 0, frame->getDuration(), receiver, getReceiverGateIndex(receiver, isNrUe(destId)));
+        if( dist > multicastD2DRange_ )
+        {
+            EV << NOW << " LtePhyBase::sendMulticast - node too far (" << dist << " > " << multicastD2DRange_ << ". skipping transmission" << endl;
+            return;
         }
     }
 
-    // delete the original frame
-    delete frame;
+    EV << NOW << " LtePhyBase::sendMulticast - sending frame to node " << destId << endl;
+
+    sendDirect(frame->dup(), 0, frame->getDuration(), receiver, getReceiverGateIndex(receiver, isNrUe(destId)));
+}
+
+LtePhyBase* LtePhyBase::getUePhy(cModule* ue, MacNodeId ueId)
+{
+    // get the correct PHY layer module
+    return (isNrUe(ueId)) ? check_and_cast<LtePhyBase *>(ue->getSubmodule("cellularNic")->getSubmodule("nrPhy"))
+                          : check_and_cast<LtePhyBase *>(ue->getSubmodule("cellularNic")->getSubmodule("phy"));
+}
+
+void LtePhyBase::getMulticastCandidates(int32_t groupId, const std::set<MacNodeId>& members, std::vector<MacNodeId>& candidates)
+{
+    // the grid is shared by all the transmitters of the group and is rebuilt once per TTI,
+    // using the multicast range as cell size
+    Binder::MulticastGroupGrid& grid = binder_->getMulticastGroupGrid(groupId);
+    double cellSize = std::max(multicastD2DRange_, 1.0);
+    if (grid.lastUpdate != NOW || grid.cellSize != cellSize)
+    {
+        grid.cells.clear();
+        grid.lastUpdate = NOW;
+        grid.cellSize = cellSize;
+        for (MacNodeId id : members)
+        {
+            OmnetId omnetId = binder_->getOmnetId(id);
+            if (omnetId == 0)
+                continue;
+
+            const inet::Coord& pos = getUePhy(getSimulation()->getModule(omnetId), id)->getRadioPosition();
+            std::pair<int,int> cell((int)floor(pos.x / grid.cellSize), (int)floor(pos.y / grid.cellSize));
+            grid.cells[cell].push_back(id);
+        }
+    }
+
+    // the range of this node is covered by the 3x3 grid cells around its own cell
+    candidates.clear();
+    const inet::Coord& myPos = getRadioPosition();
+    int cellX = (int)floor(myPos.x / grid.cellSize);
+    int cellY = (int)floor(myPos.y / grid.cellSize);
+    for (int x = cellX - 1; x <= cellX + 1; x++)
+    {
+        for (int y = cellY - 1; y <= cellY + 1; y++)
+        {
+            auto it = grid.cells.find(std::pair<int,int>(x, y));
+            if (it != grid.cells.end())
+                candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+        }
+    }
+    // keep the same delivery order as the whole group
+    std::sort(candidates.begin(), candidates.end());
 }
 
 void LtePhyBase::sendUnicast(LteAirFrame *frame)
@@ -101,6 +101,15 @@ class LtePhyBase : public ChannelAccess
     // used with the enableMulticastD2DRangeCheck_ parameter
     double multicastD2DRange_;
 
+    // candidate receivers of a multicast transmission (used with the enableMulticastD2DRangeCheck_ parameter)
+    std::vector<MacNodeId> multicastCandidates_;
+
+    // used to prevent a send direct of broadcast frames towards radios farther than broadcastRange_
+    bool enableBroadcastRangeCheck_;
+
+    // used with the enableBroadcastRangeCheck_ parameter
+    double broadcastRange_;
+
     /*
      * If true, UEs associate to the best serving cell at initialization
      */
@@ -250,6 +259,23 @@ class LtePhyBase : public ChannelAccess
 
   protected:
 
+    /**
+     * Sends a copy of the multicast frame to the given member of the group,
+     * unless it is out of range (when enableMulticastD2DRangeCheck_ is true)
+     */
+    void sendMulticastToNode(LteAirFrame *frame, MacNodeId destId);
+
+    /**
+     * Returns the PHY layer of the given UE (LTE or NR, depending on the MacNodeId)
+     */
+    LtePhyBase* getUePhy(omnetpp::cModule* ue, MacNodeId ueId);
+
+    /**
+     * Fills candidates with the members of the multicast group located in the grid cells
+     * overlapping the multicast range around this node, ordered by MacNodeId
+     */
+    void getMulticastCandidates(int32_t groupId, const std::set<MacNodeId>& members, std::vector<MacNodeId>& candidates);
+
     /**
      * Sends the given message to the wireless channel.
      *
@@ -23,11 +23,20 @@ LtePhyEnb::LtePhyEnb()
 {
     das_ = nullptr;
     bdcStarter_ = nullptr;
+    batchFeedbackSinr_ = false;
+    feedbackBatchTimer_ = nullptr;
+    batchedSinrDl_ = nullptr;
 }
 
 LtePhyEnb::~LtePhyEnb()
 {
     cancelAndDelete(bdcStarter_);
+    cancelAndDelete(feedbackBatchTimer_);
+    for (unsigned int k = 0; k < pendingFeedback_.size(); k++)
+    {
+        delete pendingFeedback_[k].first;
+        delete pendingFeedback_[k].second;
+    }
     if(lteFeedbackComputation_){
         delete lteFeedbackComputation_;
         lteFeedbackComputation_ = nullptr;
@@ -62,6 +71,13 @@ void LtePhyEnb::initialize(int stage)
 
         nodeType_ = (isNr_) ? GNODEB : ENODEB;
         WATCH(nodeType_);
+
+        batchFeedbackSinr_ = par("batchFeedbackSinr");
+        if (batchFeedbackSinr_)
+        {
+            feedbackBatchTimer_ = new cMessage("feedbackBatchTimer");
+            feedbackBatchTimer_->setSchedulingPriority(1);        // after the feedback received in this TTI
+        }
     }
     else if (stage == 1)
     {
@@ -109,6 +125,10 @@ void LtePhyEnb::handleSelfMessage(cMessage *msg)
         sendBroadcast(f);
         scheduleAt(NOW + bdcUpdateInterval_, msg);
     }
+    else if (msg->isName("feedbackBatchTimer"))
+    {
+        handleFeedbackBatch();
+    }
     else
     {
         delete msg;
@@ -141,6 +161,14 @@ bool LtePhyEnb::handleControlPkt(UserControlInfo* lteinfo, LteAirFrame* frame)
     //handle feedback pkt
     if (lteinfo->getFrameType() == FEEDBACKPKT)
     {
+        if (batchFeedbackSinr_)
+        {
+            // the feedback is processed along with the other ones received in this TTI
+            pendingFeedback_.push_back(std::make_pair(lteinfo, frame));
+            if (!feedbackBatchTimer_->isScheduled())
+                scheduleAt(NOW, feedbackBatchTimer_);
+            return true;
+        }
         handleFeedbackPkt(lteinfo, frame);
         delete frame;
         return true;
@@ -282,7 +310,7 @@ void LtePhyEnb::requestFeedback(UserControlInfo* lteinfo, LteAirFrame* frame, Pa
     //Apply analog model (pathloss)
     //Get snr for UL direction
     if (channelModel != NULL)
-        snr = channelModel->getSINR(frame, lteinfo);
+        snr = getFeedbackSinr(channelModel, lteinfo, frame);
     else
         throw cRuntimeError("LtePhyEnbD2D::requestFeedback - channelModel is null pointer. Abort");
 
@@ -345,7 +373,7 @@ void LtePhyEnb::requestFeedback(UserControlInfo* lteinfo, LteAirFrame* frame, Pa
 
             //Get snr for DL direction
             if (channelModel != NULL)
-                snr = channelModel->getSINR(frame, lteinfo);
+                snr = getFeedbackSinrDl(channelModel, lteinfo, frame);
             else
                 throw cRuntimeError("LtePhyEnbD2D::requestFeedback - channelModel is null pointer. Abort");
         }
@@ -360,6 +388,91 @@ void LtePhyEnb::requestFeedback(UserControlInfo* lteinfo, LteAirFrame* frame, Pa
     pktAux->insertAtFront(header);
 }
 
+std::vector<double> LtePhyEnb::getFeedbackSinr(LteChannelModel* channelModel, UserControlInfo* lteinfo, LteAirFrame* frame)
+{
+    // wideband feedback only uses the SINR averaged over the bands
+    if (lteinfo->feedbackReq.type == WIDEBAND)
+        return std::vector<double>(1, channelModel->getMeanSINR(frame, lteinfo));
+
+    return channelModel->getSINR(frame, lteinfo);
+}
+
+std::vector<double> LtePhyEnb::getFeedbackSinrDl(LteChannelModel* channelModel, UserControlInfo* lteinfo, LteAirFrame* frame)
+{
+    if (batchedSinrDl_ != nullptr)
+        return *batchedSinrDl_;
+
+    return getFeedbackSinr(channelModel, lteinfo, frame);
+}
+
+void LtePhyEnb::handleFeedbackBatch()
+{
+    std::vector<std::pair<UserControlInfo*, LteAirFrame*> > pending;
+    pending.swap(pendingFeedback_);
+
+    // discard the feedback of the UEs that left the simulation or this cell meanwhile
+    unsigned int numReports = 0;
+    for (unsigned int k = 0; k < pending.size(); k++)
+    {
+        MacNodeId ueId = pending[k].first->getSourceId();
+        if (binder_->getOmnetId(ueId) == 0 || binder_->getNextHop(ueId) != nodeId_)
+        {
+            EV << "LtePhyEnb::handleFeedbackBatch - discarding the feedback of UE " << ueId << endl;
+            delete pending[k].first;
+            delete pending[k].second;
+            continue;
+        }
+        pending[numReports++] = pending[k];
+    }
+    pending.resize(numReports);
+
+    // prepare the DL reports, as requestFeedback() does, and group them by carrier
+    std::vector<UserControlInfo*> dlReports(pending.size(), nullptr);
+    std::map<double, std::vector<unsigned int> > carrierReports;
+    for (unsigned int k = 0; k < pending.size(); k++)
+    {
+        UserControlInfo* lteinfo = pending[k].first;
+        if (!lteinfo->feedbackReq.request)
+            continue;
+
+        dlReports[k] = lteinfo->dup();
+        dlReports[k]->setTxPower(txPower_);
+        dlReports[k]->setDirection(DL);
+        carrierReports[lteinfo->getCarrierFrequency()].push_back(k);
+    }
+
+    // compute the DL SINR of all the UEs of each carrier at once
+    std::vector<std::vector<double> > sinrDl(pending.size());
+    std::map<double, std::vector<unsigned int> >::iterator it = carrierReports.begin();
+    for (; it != carrierReports.end(); ++it)
+    {
+        LteChannelModel* channelModel = getChannelModel(it->first);
+        if (channelModel == nullptr)
+            throw cRuntimeError("LtePhyEnb::handleFeedbackBatch - channelModel is null pointer. Abort");
+
+        std::vector<MacNodeId> ueIds;
+        std::vector<UserControlInfo*> reports;
+        for (unsigned int j = 0; j < it->second.size(); j++)
+        {
+            ueIds.push_back(pending[it->second[j]].first->getSourceId());
+            reports.push_back(dlReports[it->second[j]]);
+        }
+        std::vector<std::vector<double> > sinr = channelModel->getSINRBatch(nodeId_, ueIds, it->first, reports);
+        for (unsigned int j = 0; j < it->second.size(); j++)
+            sinrDl[it->second[j]].swap(sinr[j]);
+    }
+
+    // process the feedback in order of reception
+    for (unsigned int k = 0; k < pending.size(); k++)
+    {
+        batchedSinrDl_ = (dlReports[k] != nullptr) ? &sinrDl[k] : nullptr;
+        handleFeedbackPkt(pending[k].first, pending[k].second);
+        delete pending[k].second;
+        delete dlReports[k];
+    }
+    batchedSinrDl_ = nullptr;
+}
+
 void LtePhyEnb::handleFeedbackPkt(UserControlInfo* lteinfo,
     LteAirFrame *frame)
 {
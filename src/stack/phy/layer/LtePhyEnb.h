@@ -35,13 +35,38 @@ class LtePhyEnb : public LtePhyBase
      */
     DasFilter* das_;
 
+    /** If true, the DL SINR of the feedback reports received within a TTI is computed by a single batch evaluation */
+    bool batchFeedbackSinr_;
+
+    /** Feedback frames received in the current TTI, processed all together by feedbackBatchTimer_ */
+    std::vector<std::pair<UserControlInfo*, LteAirFrame*> > pendingFeedback_;
+    omnetpp::cMessage* feedbackBatchTimer_;
+
+    /** DL SINR computed by the batch evaluation for the feedback being processed, or nullptr */
+    const std::vector<double>* batchedSinrDl_;
+
     virtual void initialize(int stage);
 
     virtual void handleSelfMessage(omnetpp::cMessage *msg);
     virtual void handleAirFrame(omnetpp::cMessage* msg);
     bool handleControlPkt(UserControlInfo* lteinfo, LteAirFrame* frame);
     void handleFeedbackPkt(UserControlInfo* lteinfo, LteAirFrame* frame);
+    /**
+     * Computes the DL SINR of all the feedback received in the current TTI with a single call
+     * to LteChannelModel::getSINRBatch() per carrier, then processes each feedback in order of reception
+     */
+    void handleFeedbackBatch();
     virtual void requestFeedback(UserControlInfo* lteinfo, LteAirFrame* frame, inet::Packet* pkt);
+    /**
+     * Returns the SINR for the feedback carried by the given frame. For wideband feedback,
+     * only the SINR averaged over all the bands is returned
+     */
+    std::vector<double> getFeedbackSinr(LteChannelModel* channelModel, UserControlInfo* lteinfo, LteAirFrame* frame);
+    /**
+     * Returns the DL SINR for the feedback carried by the given frame. If batchFeedbackSinr
+     * is enabled, the SINR has already been computed by handleFeedbackBatch()
+     */
+    std::vector<double> getFeedbackSinrDl(LteChannelModel* channelModel, UserControlInfo* lteinfo, LteAirFrame* frame);
     /**
      * Getter for the Das Filter
      */
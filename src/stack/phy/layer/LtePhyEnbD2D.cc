@@ -49,7 +49,7 @@ void LtePhyEnbD2D::requestFeedback(UserControlInfo* lteinfo, LteAirFrame* frame,
     //Get snr for UL direction
     std::vector<double> snr;
     if (channelModel != NULL)
-        snr = channelModel->getSINR(frame, lteinfo);
+        snr = getFeedbackSinr(channelModel, lteinfo, frame);
     else
         throw cRuntimeError("LtePhyEnbD2D::requestFeedback - channelModel is null pointer. Abort");
     FeedbackRequest req = lteinfo->feedbackReq;
@@ -107,7 +107,7 @@ void LtePhyEnbD2D::requestFeedback(UserControlInfo* lteinfo, LteAirFrame* frame,
             lteinfo->setDirection(DL);
             //Get snr for DL direction
             if (channelModel != NULL)
-                snr = channelModel->getSINR(frame, lteinfo);
+                snr = getFeedbackSinrDl(channelModel, lteinfo, frame);
             else
                 throw cRuntimeError("LtePhyEnbD2D::requestFeedback - channelModel is null pointer. Abort");
 
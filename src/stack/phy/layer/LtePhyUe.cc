@@ -53,6 +53,11 @@ void LtePhyUe::initialize(int stage)
         else
             minRssi_ = par("minRssi").doubleValue();
 
+        widebandHandoverRssi_ = par("widebandHandoverRssi");
+        cacheHandoverRssi_ = par("cacheHandoverRssi");
+        handoverCandidateRadius_ = par("handoverCandidateRadius");
+        handoverRssiWindow_ = par("handoverRssiWindow");
+
         currentMasterRssi_ = -999.0;
         candidateMasterRssi_ = -999.0;
         hysteresisTh_ = 0;
@@ -270,13 +275,42 @@ void LtePhyUe::handoverHandler(LteAirFrame* frame, UserControlInfo* lteInfo)
     frame->setControlInfo(lteInfo);
     double rssi;
 
+    if (lteInfo->getSourceId() != masterId_ && handoverCandidateRadius_ >= 0 && getCoord().distance(lteInfo->getCoord()) > handoverCandidateRadius_)
+    {
+        EV << "Candidate master " << lteInfo->getSourceId() << " is too far - handoverCandidateRadius[" << handoverCandidateRadius_ << "]" << endl;
+        delete frame;
+        return;
+    }
+
     if (getNodeTypeById(lteInfo->getSourceId()) == ENODEB && lteInfo->getSourceId() == masterId_)
     {
         // Broadcast message from my master enb
         rssi = das_->receiveBroadcast(frame, lteInfo);
+
+        // use the same metric for all the cells
+        if (widebandHandoverRssi_)
+            rssi = getWidebandRssi(frame, lteInfo);
+    }
+    else if (widebandHandoverRssi_)
+    {
+        rssi = getWidebandRssi(frame, lteInfo);
     }
     else
     {
+        if (lteInfo->getSourceId() != masterId_ && handoverRssiWindow_ >= 0)
+        {
+            // the wideband SNR is an estimate of the SINR without fading and interference: skip the full
+            // evaluation if it is too low for this cell to become the handover candidate
+            double snr = getWidebandRssi(frame, lteInfo);
+            double requiredRssi = std::max(minRssi_, candidateMasterRssi_ + hysteresisTh_);
+            if (snr < requiredRssi - handoverRssiWindow_)
+            {
+                EV << "Signal too weak from a candidate master - wideband SNR[" << snr << "] required RSSI[" << requiredRssi << "]" << endl;
+                delete frame;
+                return;
+            }
+        }
+
         // Broadcast message from not-master enb
         std::vector<double>::iterator it;
         rssi = 0;
@@ -359,6 +393,33 @@ void LtePhyUe::handoverHandler(LteAirFrame* frame, UserControlInfo* lteInfo)
     delete frame;
 }
 
+double LtePhyUe::getWidebandRssi(LteAirFrame* frame, UserControlInfo* lteInfo)
+{
+    MacNodeId enbId = lteInfo->getSourceId();
+    if (cacheHandoverRssi_)
+    {
+        std::map<MacNodeId, HandoverRssi>::iterator it = handoverRssiCache_.find(enbId);
+        if (it != handoverRssiCache_.end() && it->second.ueCoord == getCoord() && it->second.enbCoord == lteInfo->getCoord()
+                && it->second.txPower == lteInfo->getTxPower())
+        {
+            EV << "LtePhyUe::getWidebandRssi - using cached RSSI from " << enbId << endl;
+            return it->second.rssi;
+        }
+    }
+
+    double rssi = primaryChannelModel_->getWidebandSNR(frame, lteInfo);
+
+    if (cacheHandoverRssi_)
+    {
+        HandoverRssi& entry = handoverRssiCache_[enbId];
+        entry.ueCoord = getCoord();
+        entry.enbCoord = lteInfo->getCoord();
+        entry.txPower = lteInfo->getTxPower();
+        entry.rssi = rssi;
+    }
+    return rssi;
+}
+
 void LtePhyUe::triggerHandover()
 {
     ASSERT(masterId_ != candidateMasterId_);
@@ -81,6 +81,39 @@ class LtePhyUe : public LtePhyBase
      */
     bool enableHandover_;
 
+    /**
+     * If true, the RSSI of handover broadcast frames is evaluated as a wideband SNR value
+     */
+    bool widebandHandoverRssi_;
+
+    /**
+     * If true, the wideband RSSI from each cell is reused as long as neither the UE nor the cell moves
+     */
+    bool cacheHandoverRssi_;
+
+    /**
+     * Broadcast frames from non-serving cells farther than this distance are ignored (disabled if negative)
+     */
+    double handoverCandidateRadius_;
+
+    /**
+     * Broadcast frames from non-serving cells are fully evaluated only if their wideband SNR is within
+     * this window from the RSSI required to become the handover candidate (disabled if negative)
+     */
+    double handoverRssiWindow_;
+
+    /**
+     * Last wideband RSSI computed for each cell, together with the positions it refers to
+     */
+    struct HandoverRssi
+    {
+        inet::Coord ueCoord;
+        inet::Coord enbCoord;
+        double txPower;
+        double rssi;
+    };
+    std::map<MacNodeId, HandoverRssi> handoverRssiCache_;
+
     /**
      * Pointer to the DAS Filter: used to call das function
      * when receiving broadcasts and to retrieve physical
@@ -128,6 +161,11 @@ class LtePhyUe : public LtePhyBase
 
     void handoverHandler(LteAirFrame* frame, UserControlInfo* lteInfo);
 
+    /**
+     * Returns the wideband RSSI of the given broadcast frame, using the cached value if possible
+     */
+    double getWidebandRssi(LteAirFrame* frame, UserControlInfo* lteInfo);
+
     void deleteOldBuffers(MacNodeId masterId);
 
     virtual void triggerHandover();
@@ -9,6 +9,7 @@
 // and cannot be removed from it.
 //
 #include <cassert>
+#include <algorithm>
 
 #include <inet/common/INETMath.h>
 
@@ -36,6 +37,10 @@ void LteChannelControl::initialize()
 {
     coreEV << "initializing LteChannelControl\n";
     ChannelControl::initialize();
+
+    gridCellSize_ = par("gridCellSize");
+    if (gridCellSize_ <= 0)
+        throw cRuntimeError("LteChannelControl::initialize - gridCellSize must be positive");
 }
 
 /**
@@ -89,3 +94,85 @@ void LteChannelControl::sendToChannel(RadioRef srcRadio, AirFrame *airFrame)
     // the original frame can be deleted
     delete airFrame;
 }
+
+LteChannelControl::GridCell LteChannelControl::getGridCell(const inet::Coord& pos) const
+{
+    return GridCell((int)floor(pos.x / gridCellSize_), (int)floor(pos.y / gridCellSize_));
+}
+
+void LteChannelControl::updateRadioGrid(RadioRef r)
+{
+    GridCell cell = getGridCell(r->pos);
+    auto it = radioCell_.find(r);
+    if (it != radioCell_.end())
+    {
+        if (it->second == cell)
+            return;
+        radioGrid_[it->second].erase(r);
+        it->second = cell;
+    }
+    else
+        radioCell_[r] = cell;
+
+    radioGrid_[cell].insert(r);
+}
+
+void LteChannelControl::unregisterRadio(RadioRef r)
+{
+    Enter_Method_Silent();
+    auto it = radioCell_.find(r);
+    if (it != radioCell_.end())
+    {
+        radioGrid_[it->second].erase(r);
+        radioCell_.erase(it);
+    }
+    ChannelControl::unregisterRadio(r);
+}
+
+void LteChannelControl::setRadioPosition(RadioRef r, const inet::Coord& pos)
+{
+    ChannelControl::setRadioPosition(r, pos);
+    updateRadioGrid(r);
+}
+
+void LteChannelControl::sendToChannelInRange(RadioRef srcRadio, AirFrame *airFrame, double range)
+{
+    // NOTE: no Enter_Method()! We pretend this method is part of ChannelAccess
+
+    // collect the neighbors within range, visiting only the grid cells overlapping the range
+    std::vector<RadioRef> receivers;
+    double rangeSquared = range * range;
+    GridCell minCell = getGridCell(inet::Coord(srcRadio->pos.x - range, srcRadio->pos.y - range));
+    GridCell maxCell = getGridCell(inet::Coord(srcRadio->pos.x + range, srcRadio->pos.y + range));
+    for (int x = minCell.first; x <= maxCell.first; x++)
+    {
+        for (int y = minCell.second; y <= maxCell.second; y++)
+        {
+            auto cit = radioGrid_.find(GridCell(x, y));
+            if (cit == radioGrid_.end())
+                continue;
+
+            for (auto r : cit->second)
+            {
+                if (r == srcRadio || srcRadio->pos.sqrdist(r->pos) > rangeSquared)
+                    continue;
+                // only radios within the interference distance are reachable
+                if (srcRadio->neighbors.find(r) == srcRadio->neighbors.end())
+                    continue;
+                receivers.push_back(r);
+            }
+        }
+    }
+    // keep the same delivery order as sendToChannel()
+    std::sort(receivers.begin(), receivers.end(), RadioEntry::Compare());
+
+    coreEV << "sending message to " << receivers.size() << " radio(s) out of " << srcRadio->neighbors.size() << " neighbor(s)\n";
+    for (auto r : receivers)
+    {
+        simtime_t delay = 0.0;
+        check_and_cast<cSimpleModule*>(srcRadio->radioModule)->sendDirect(airFrame->dup(), delay, airFrame->getDuration(), r->radioInGate);
+    }
+
+    // the original frame can be deleted
+    delete airFrame;
+}
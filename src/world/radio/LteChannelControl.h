@@ -12,6 +12,7 @@
 #ifndef LTECHANNELCONTROL_H
 #define LTECHANNELCONTROL_H
 
+#include <map>
 #include "world/radio/ChannelControl.h"
 
 /**
@@ -23,6 +24,25 @@
 class LteChannelControl : public ChannelControl
 {
   protected:
+    typedef std::pair<int,int> GridCell;
+    typedef std::map<GridCell, std::set<RadioRef, RadioEntry::Compare> > RadioGrid;
+
+    /*
+     * Uniform grid of the registered radios, used to find the radios
+     * close to a given one without scanning the whole radio list.
+     * Radios are stored in a set ordered by module id, i.e. the same
+     * order used by the neighbor lists
+     */
+    RadioGrid radioGrid_;
+    std::map<RadioRef, GridCell> radioCell_;
+    double gridCellSize_;
+
+    /** Returns the grid cell containing the given position */
+    GridCell getGridCell(const inet::Coord& pos) const;
+
+    /** Moves the radio to the grid cell corresponding to its current position */
+    void updateRadioGrid(RadioRef r);
+
 
     /** Calculate interference distance*/
     virtual double calcInterfDist();
@@ -35,6 +55,16 @@ class LteChannelControl : public ChannelControl
 
     /** Called from ChannelAccess, to transmit a frame to all the radios in range, on the frame's channel */
     virtual void sendToChannel(RadioRef srcRadio, AirFrame *airFrame);
+
+    /*
+     * Transmits a frame only to the neighbors of srcRadio whose distance
+     * from it does not exceed the given range. Frames are delivered in the
+     * same order as sendToChannel()
+     */
+    virtual void sendToChannelInRange(RadioRef srcRadio, AirFrame *airFrame, double range);
+
+    virtual void unregisterRadio(RadioRef r) override;
+    virtual void setRadioPosition(RadioRef r, const inet::Coord& pos) override;
 };
 
 #endif